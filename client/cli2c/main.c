@@ -15,6 +15,9 @@ static inline void  show_help(void);
 static inline void  show_version(void);
 static inline void  show_commands(void);
 static inline void  show_bad_command_help(char* command);
+static bool         show_perf(SerialDriver *sd, bool do_clear);
+static bool         sample_device(SerialDriver *sd, uint8_t address, uint8_t reg, size_t byte_count, uint16_t period_ms, uint32_t sample_count);
+static bool         trigger_device(SerialDriver *sd, uint8_t pin, uint8_t edges, uint8_t address, uint8_t reg, size_t byte_count, uint32_t event_count);
 static int          process_commands(SerialDriver *sd, int argc, char *argv[], uint32_t delta);
 
 
@@ -120,7 +123,9 @@ static inline void show_commands(void) {
 
     fprintf(stderr, "Commands:\n");
     fprintf(stderr, "  z                                Initialise the I2C bus.\n");
-    fprintf(stderr, "  c {bus ID} {SDA pin} {SCL pin}   Configure the I2C bus.\n");
+    fprintf(stderr, "  c {bus ID} {SDA pin} {SCL pin}   Configure the I2C bus, and use it.\n");
+    fprintf(stderr, "  b {bus ID}                       Use a configured I2C bus. Both buses keep their pins,\n");
+    fprintf(stderr, "                                   speed and state, so they can be used in turn.\n");
     fprintf(stderr, "  f {frequency}                    Set the I2C bus frequency in multiples of 100kHz.\n");
     fprintf(stderr, "                                   Only 1 and 4 are supported.\n");
     fprintf(stderr, "  w {address} {bytes}              Write bytes out to I2C.\n");
@@ -132,6 +137,15 @@ static inline void show_commands(void) {
     fprintf(stderr, "  i                                Get I2C bus host device information.\n");
     fprintf(stderr, "  g {number} [hi|lo] [in|out]      Control a GPIO pin.\n");
     fprintf(stderr, "  l {on|off}                       Turn the I2C bus host LED on or off.\n");
+    fprintf(stderr, "  j {address} {register} {count}   Have the host read count bytes from a device register\n");
+    fprintf(stderr, "    {period} {samples}             every period ms, and print each sample's host timestamp\n");
+    fprintf(stderr, "                                   (us) and data. Stops after the given number of samples.\n");
+    fprintf(stderr, "  t {pin} {rise|fall|both}         Have the host read count bytes from a device register\n");
+    fprintf(stderr, "    {address} {register} {count}  whenever the pin sees the edge, and print each read's\n");
+    fprintf(stderr, "    {events}                       edge timestamp (us) and data. Stops after the given\n");
+    fprintf(stderr, "                                   number of events.\n");
+    fprintf(stderr, "  m [clear]                        Show the host's performance counters, optionally\n");
+    fprintf(stderr, "                                   clearing them afterwards.\n");
     fprintf(stderr, "  h                                Show help and quit.\n");
 }
 
@@ -147,6 +161,174 @@ static inline void show_bad_command_help(char* command) {
 }
 
 
+/**
+ * @brief Output the board's performance counters: bus totals, then
+ *        each command's count and latency percentiles. Percentiles are
+ *        histogram bucket upper bounds, so they over-estimate by up to 2x.
+ *        FROM 1.3.0
+ *
+ * @param sd:       Pointer to a SerialDriver structure.
+ * @param do_clear: Have the board zero its counters afterwards.
+ *
+ * @returns Whether the counters were read (`true`) or not (`false`).
+ */
+static bool show_perf(SerialDriver *sd, bool do_clear) {
+
+    PerfHeader header;
+    PerfSlot slots[PERF_COMMAND_SLOTS];
+    if (!serial_get_perf(sd, do_clear, &header, slots)) return false;
+
+    fprintf(stderr, "Counters for the last %ums:\n", header.elapsed_ms);
+    fprintf(stderr, "  I2C bytes written: %u, read: %u, NAKs: %u, timeouts: %u\n",
+            header.i2c_bytes_written, header.i2c_bytes_read, header.i2c_nak_count, header.i2c_timeout_count);
+    fprintf(stderr, "  1-Wire bytes written: %u, read: %u\n", header.ow_bytes_written, header.ow_bytes_read);
+    fprintf(stderr, "  Rejected frames: %u\n", header.rejected_frames);
+    fprintf(stderr, "  Command       Count     p50 (us)   p99 (us)   Max (us)\n");
+
+    for (uint32_t i = 0 ; i < header.slot_count ; ++i) {
+        uint32_t p50 = 0, p99 = 0, max = 0, seen = 0;
+        for (uint32_t j = 0 ; j < header.bucket_count && j < PERF_HISTOGRAM_BUCKETS ; ++j) {
+            uint32_t upper = j == 0 ? 0 : (1 << j) - 1;
+            if (slots[i].latency[j] == 0) continue;
+            seen += slots[i].latency[j];
+            if (p50 == 0 && seen * 2 >= slots[i].count) p50 = upper;
+            if (p99 == 0 && seen * 100 >= slots[i].count * 99) p99 = upper;
+            max = upper;
+        }
+
+        char name[8];
+        if (slots[i].command == PREFIX_BYTE_READ) {
+            strcpy(name, "read");
+        } else if (slots[i].command == PREFIX_BYTE_WRITE) {
+            strcpy(name, "write");
+        } else {
+            sprintf(name, "'%c'", slots[i].command);
+        }
+
+        fprintf(stderr, "  %-8s %10u %12u %10u %10u\n", name, slots[i].count, p50, p99, max);
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Have the board sample a device register, and output each sample
+ *        on a line: its sequence number, board timestamp and data in hex.
+ *        FROM 1.3.0
+ *
+ * @param sd:           Pointer to a SerialDriver structure.
+ * @param address:      The device's I2C address.
+ * @param reg:          The register to read.
+ * @param byte_count:   The number of bytes to read.
+ * @param period_ms:    The sampling period in milliseconds.
+ * @param sample_count: The number of samples to take.
+ *
+ * @returns Whether sampling succeeded (`true`) or not (`false`).
+ */
+static bool sample_device(SerialDriver *sd, uint8_t address, uint8_t reg, size_t byte_count, uint16_t period_ms, uint32_t sample_count) {
+
+    Program program;
+    serial_program_init(&program);
+    i2c_transaction_write(&program, address, &reg, 1);
+    i2c_transaction_read(&program, address, byte_count);
+    i2c_transaction_stop(&program);
+
+    if (!serial_subscribe(sd, period_ms, &program)) {
+        print_error("Could not start sampling");
+        return false;
+    }
+
+    SampleHeader header;
+    uint8_t data[EXTENDED_FRAME_MAX_B];
+    uint32_t received = 0;
+    uint32_t misses = 0;
+    while (received < sample_count) {
+        // Long periods may time out between samples, but
+        // give up if the board has clearly stopped sending
+        if (!serial_next_sample(sd, &header, data, sizeof(data))) {
+            if (++misses > period_ms / 1000 + 2) {
+                print_error("Sample stream stalled");
+                serial_unsubscribe(sd);
+                return false;
+            }
+
+            continue;
+        }
+
+        misses = 0;
+        received++;
+
+        printf("%u %u", header.sequence, header.timestamp_us);
+        if (header.flags & SAMPLE_FLAG_ERROR) {
+            printf(" error 0x%02X", header.error);
+        } else {
+            for (uint32_t i = 0 ; i < header.length ; ++i) printf(" %02X", data[i]);
+        }
+
+        if (header.flags & SAMPLE_FLAG_OVERRUN) printf(" overrun");
+        printf("\n");
+        fflush(stdout);
+    }
+
+    return serial_unsubscribe(sd);
+}
+
+
+/**
+ * @brief Have the board read a device register whenever a pin sees an
+ *        edge, and output each read on a line: its sequence number, edge
+ *        timestamp and data in hex.
+ *        FROM 1.3.0
+ *
+ * @param sd:          Pointer to a SerialDriver structure.
+ * @param pin:         The GPIO pin to watch.
+ * @param edges:       TRIGGER_EDGE_* values.
+ * @param address:     The device's I2C address.
+ * @param reg:         The register to read.
+ * @param byte_count:  The number of bytes to read.
+ * @param event_count: The number of edges to report.
+ *
+ * @returns Whether triggering succeeded (`true`) or not (`false`).
+ */
+static bool trigger_device(SerialDriver *sd, uint8_t pin, uint8_t edges, uint8_t address, uint8_t reg, size_t byte_count, uint32_t event_count) {
+
+    Program program;
+    serial_program_init(&program);
+    i2c_transaction_write(&program, address, &reg, 1);
+    i2c_transaction_read(&program, address, byte_count);
+    i2c_transaction_stop(&program);
+
+    if (!serial_arm_trigger(sd, pin, edges, &program)) {
+        print_error("Could not arm a trigger on pin %i", pin);
+        return false;
+    }
+
+    SampleHeader header;
+    uint8_t data[EXTENDED_FRAME_MAX_B];
+    uint32_t received = 0;
+    while (received < event_count) {
+        // Edges come when they come, so just keep waiting
+        if (!serial_next_sample(sd, &header, data, sizeof(data))) continue;
+        if (!(header.flags & SAMPLE_FLAG_TRIGGER) || header.pin != pin) continue;
+        received++;
+
+        printf("%u %u", header.sequence, header.timestamp_us);
+        if (header.flags & SAMPLE_FLAG_ERROR) {
+            printf(" error 0x%02X", header.error);
+        } else {
+            for (uint32_t i = 0 ; i < header.length ; ++i) printf(" %02X", data[i]);
+        }
+
+        if (header.flags & SAMPLE_FLAG_OVERRUN) printf(" overrun");
+        printf("\n");
+        fflush(stdout);
+    }
+
+    return serial_disarm_trigger(sd, pin);
+}
+
+
 #pragma mark - Command Parsing and Processing
 
 /**
@@ -186,6 +368,29 @@ static int process_commands(SerialDriver *sd, int argc, char *argv[], uint32_t d
         }
 
         switch (command[0]) {
+            // FROM 1.3.0
+            case 'B':
+            case 'b':   // SWITCH TO A CONFIGURED I2C BUS
+                {
+                    if (i < argc - 1) {
+                        long bus_id = strtol(argv[++i], NULL, 0);
+                        if (bus_id != 1 && bus_id != 0) {
+                            print_error("Incorrect I2C bus ID selected. Should be 0 or 1");
+                            return EXIT_ERR;
+                        }
+
+                        if (!i2c_select_bus(sd, (uint8_t)bus_id)) {
+                            print_error("I2C bus selection un-ACK’d");
+                            return EXIT_ERR;
+                        }
+
+                        break;
+                    }
+
+                    print_error("No I2C bus ID given");
+                    return EXIT_ERR;
+                }
+
             case 'C':
             case 'c':   // CHOOSE I2C BUS AND (FROM 1.1.0) PINS
                 {
@@ -385,6 +590,82 @@ static int process_commands(SerialDriver *sd, int argc, char *argv[], uint32_t d
                     return EXIT_ERR;
                 }
 
+            // FROM 1.3.0
+            case 'J':
+            case 'j':   // SAMPLE A DEVICE REGISTER PERIODICALLY
+                {
+                    if (i < argc - 5) {
+                        long address = strtol(argv[++i], NULL, 0);
+                        long reg = strtol(argv[++i], NULL, 0);
+                        long num_bytes = strtol(argv[++i], NULL, 0);
+                        long period = strtol(argv[++i], NULL, 0);
+                        long samples = strtol(argv[++i], NULL, 0);
+                        if (address < 0 || address > 0x7F || reg < 0 || reg > 0xFF || num_bytes < 1 ||
+                            period < 1 || period > 0xFFFF || samples < 1) {
+                            print_error("Invalid sampling parameters");
+                            return EXIT_ERR;
+                        }
+
+                        if (!sample_device(sd, address, reg, num_bytes, period, samples)) return EXIT_ERR;
+                        break;
+                    }
+
+                    print_error("Sampling needs an address, register, byte count, period and sample count");
+                    return EXIT_ERR;
+                }
+
+            // FROM 1.3.0
+            case 'T':
+            case 't':   // READ A DEVICE REGISTER ON A PIN EDGE
+                {
+                    if (i < argc - 6) {
+                        long pin = strtol(argv[++i], NULL, 0);
+                        char* edge = argv[++i];
+                        long address = strtol(argv[++i], NULL, 0);
+                        long reg = strtol(argv[++i], NULL, 0);
+                        long num_bytes = strtol(argv[++i], NULL, 0);
+                        long events = strtol(argv[++i], NULL, 0);
+
+                        uint8_t edges = 0;
+                        if (strcasecmp(edge, "rise") == 0) {
+                            edges = TRIGGER_EDGE_RISE;
+                        } else if (strcasecmp(edge, "fall") == 0) {
+                            edges = TRIGGER_EDGE_FALL;
+                        } else if (strcasecmp(edge, "both") == 0) {
+                            edges = TRIGGER_EDGE_RISE | TRIGGER_EDGE_FALL;
+                        }
+
+                        if (pin < 0 || pin > 31 || edges == 0 || address < 0 || address > 0x7F ||
+                            reg < 0 || reg > 0xFF || num_bytes < 1 || events < 1) {
+                            print_error("Invalid trigger parameters");
+                            return EXIT_ERR;
+                        }
+
+                        if (!trigger_device(sd, pin, edges, address, reg, num_bytes, events)) return EXIT_ERR;
+                        break;
+                    }
+
+                    print_error("A trigger needs a pin, edge, address, register, byte count and event count");
+                    return EXIT_ERR;
+                }
+
+            // FROM 1.3.0
+            case 'M':
+            case 'm':   // SHOW THE BOARD'S PERFORMANCE COUNTERS
+                {
+                    bool do_clear = false;
+                    if (i < argc - 1 && strcasecmp(argv[i + 1], "clear") == 0) {
+                        do_clear = true;
+                        i++;
+                    }
+
+                    if (!show_perf(sd, do_clear)) {
+                        print_error("Could not get performance counters");
+                        return EXIT_ERR;
+                    }
+                }
+                break;
+
             case 'P':
             case 'p':   // ISSUE AN I2C STOP
                 i2c_stop(sd);
@@ -449,6 +730,37 @@ static int process_commands(SerialDriver *sd, int argc, char *argv[], uint32_t d
                                 endptr++;
                             }
 
+                            // FROM 1.3.0
+                            // A write followed by a read, eg. to get a register value,
+                            // goes to the board as a single transaction program
+                            if (i < argc - 2 && (strcasecmp(argv[i + 1], "r") == 0 || strcasecmp(argv[i + 1], "-r") == 0)
+                                && serial_firmware_at_least(sd, 1, 3)) {
+                                long read_address = strtol(argv[i + 2], NULL, 0);
+                                if (i < argc - 3) {
+                                    size_t num_read = strtol(argv[i + 3], NULL, 0);
+                                    static Program program;
+                                    serial_program_init(&program);
+                                    i2c_transaction_write(&program, (uint8_t)address, bytes, num_bytes);
+                                    i2c_transaction_stop(&program);
+                                    i2c_transaction_read(&program, (uint8_t)read_address, num_read);
+                                    i2c_transaction_stop(&program);
+
+                                    uint8_t read_bytes[EXTENDED_FRAME_MAX_B];
+                                    if (num_read > sizeof(read_bytes) || !i2c_transaction(sd, &program, read_bytes)) {
+                                        print_error("Could not write then read");
+                                        return EXIT_ERR;
+                                    }
+
+                                    for (size_t j = 0 ; j < num_read ; ++j) {
+                                        fprintf(stdout, "%02X", read_bytes[j]);
+                                    }
+
+                                    fprintf(stdout, "\n");
+                                    i += 3;
+                                    break;
+                                }
+                            }
+
                             i2c_start(sd, (uint8_t)address, 0);
                             i2c_write(sd, bytes, num_bytes);
                             break;
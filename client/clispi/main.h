@@ -0,0 +1,22 @@
+/*
+ * macOS/Linux SPI CLI utility
+ *
+ * Version 1.3.0
+ * Copyright © 2023, Tony Smith (@smittytone)
+ * Licence: MIT
+ *
+ */
+#ifndef _MAIN_H_
+#define _MAIN_H_
+
+
+/*
+ * INCLUDES
+ */
+#include "serialdriver.h"
+#include "utils.h"
+#include "gpio.h"
+#include "spidriver.h"
+
+
+#endif      // _MAIN_H_
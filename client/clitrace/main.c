@@ -0,0 +1,204 @@
+/*
+ * macOS/Linux command trace utility
+ *
+ * Version 1.3.0
+ * Copyright © 2023, Tony Smith (@smittytone)
+ * Licence: MIT
+ *
+ */
+#include "main.h"
+
+
+#pragma mark - Static Prototypes
+
+static inline void  show_help(void);
+static inline void  show_version(void);
+static void         show_trace(TraceHeader *header, TraceRecord records[], uint32_t slow_us);
+static void         frame_name(TraceRecord *record, char* name);
+
+
+#pragma mark - Global Vars
+
+// A serial comms structure
+SerialDriver board;
+
+// The trace, which is too large for the stack
+TraceRecord records[TRACE_RECORD_COUNT_MAX];
+
+
+#pragma mark - Main Function
+
+/**
+ * @brief Main entry point.
+ */
+int main(int argc, char *argv[]) {
+
+    // Listen for SIGINT
+    signal(SIGINT, ctrl_c_handler);
+
+    // Process arguments
+    if (argc < 2) {
+        // Insufficient arguments -- issue usage info and bail
+        fprintf(stderr, "Usage: clitrace {DEVICE_PATH} [options]\n");
+        return EXIT_OK;
+    }
+
+    bool do_clear = false;
+    uint32_t slow_us = 0;
+    for (int i = 1 ; i < argc ; ++i) {
+        if (strcasecmp(argv[i], "h") == 0 ||
+            strcasecmp(argv[i], "--help") == 0 ||
+            strcasecmp(argv[i], "-h") == 0) {
+            show_help();
+            return EXIT_OK;
+        }
+
+        if (strcasecmp(argv[i], "v") == 0 ||
+            strcasecmp(argv[i], "--version") == 0 ||
+            strcasecmp(argv[i], "-v") == 0) {
+            show_version();
+            return EXIT_OK;
+        }
+
+        if (i == 1) continue;
+
+        if (strcasecmp(argv[i], "--clear") == 0 || strcasecmp(argv[i], "-c") == 0) {
+            do_clear = true;
+        } else if ((strcasecmp(argv[i], "--slow") == 0 || strcasecmp(argv[i], "-s") == 0) && i < argc - 1) {
+            slow_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            print_error("Bad option: %s", argv[i]);
+            return EXIT_ERR;
+        }
+    }
+
+    // Connect... with the device path
+    board.file_descriptor = -1;
+    serial_connect(&board, argv[1]);
+    if (!board.is_connected) {
+        if (board.file_descriptor != -1) serial_flush_and_close_port(&board);
+        return EXIT_ERR;
+    }
+
+    // The trace arrived in firmware 1.3.0
+    if (!serial_firmware_at_least(&board, 1, 3)) {
+        serial_flush_and_close_port(&board);
+        fprintf(stderr, "clitrace requires a board with firmware 1.3.0 or above... exiting\n");
+        return EXIT_ERR;
+    }
+
+    TraceHeader header;
+    bool success = serial_get_trace(&board, do_clear, &header, records);
+    serial_flush_and_close_port(&board);
+
+    if (!success) {
+        print_error("Could not get the trace");
+        return EXIT_ERR;
+    }
+
+    show_trace(&header, records, slow_us);
+    return EXIT_OK;
+}
+
+
+#pragma mark - User Messaging Functions
+
+/**
+ * @brief Show help.
+ */
+static inline void show_help(void) {
+
+    fprintf(stderr, "clitrace {device} [options]\n\n");
+    fprintf(stderr, "Usage:\n");
+    fprintf(stderr, "  {device} is a mandatory device path, eg. /dev/cu.usbmodem-101.\n");
+    fprintf(stderr, "  [options] are optional, as shown below.\n\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -c / --clear                     Clear the board's trace once it has been read.\n");
+    fprintf(stderr, "  -s / --slow {microseconds}       Mark frames that took at least this long.\n");
+    fprintf(stderr, "  -h / --help                      Show help and quit.\n");
+    fprintf(stderr, "  -v / --version                   Show version information and quit.\n");
+}
+
+
+/**
+ * @brief Show app version.
+ */
+static inline void show_version(void) {
+
+    fprintf(stderr, "clitrace %s\n", APP_VERSION);
+    fprintf(stderr, "Copyright © 2023, Tony Smith.\n");
+}
+
+
+#pragma mark - Trace Decoding Functions
+
+/**
+ * @brief Output the trace as a timeline. Times are relative to the first
+ *        record. The gap is from the end of the previous frame's reply to
+ *        this frame's arrival: a negative gap means the frame was queued
+ *        behind the previous one.
+ *
+ * @param header:  Pointer to the trace's header.
+ * @param records: The trace records, oldest first.
+ * @param slow_us: Mark frames that took at least this long, or 0.
+ */
+static void show_trace(TraceHeader *header, TraceRecord records[], uint32_t slow_us) {
+
+    printf("Trace: %u records, %u dropped\n", header->record_count, header->dropped_count);
+    if (header->record_count == 0) return;
+
+    printf("     #   Time (ms)   Gap (us)  Took (us)  Frame   Seq  Length  Mode  Bus  Result\n");
+
+    uint32_t start_us = records[0].received_us;
+    uint32_t slowest = 0;
+    for (uint32_t i = 0 ; i < header->record_count ; ++i) {
+        TraceRecord *record = &records[i];
+
+        // Board times are the low 32 bits of a microsecond counter,
+        // so work with unsigned differences to survive wrapping
+        double time_ms = (double)(record->received_us - start_us) / 1000.0;
+        int32_t gap_us = 0;
+        if (i > 0) gap_us = (int32_t)(record->received_us - (records[i - 1].received_us + records[i - 1].duration_us));
+        if (record->duration_us > records[slowest].duration_us) slowest = i;
+
+        char name[8];
+        char sequence[4] = "-";
+        char result[8] = "OK";
+        frame_name(record, name);
+        if (record->sequence != TRACE_NO_SEQUENCE) sprintf(sequence, "%u", record->sequence);
+        if (record->result != 0) sprintf(result, "0x%02X", record->result);
+
+        printf("%6u %11.3f %10i %10u  %-6s %4s %7u     %c   %c%c  %s%s\n",
+               i + 1, time_ms, gap_us, record->duration_us, name, sequence, record->length, record->mode,
+               (record->bus_flags & TRACE_BUS_FLAG_READY) ? 'R' : '-',
+               (record->bus_flags & TRACE_BUS_FLAG_STARTED) ? 'S' : '-',
+               result,
+               (slow_us > 0 && record->duration_us >= slow_us) ? "  <-- SLOW" : "");
+    }
+
+    TraceRecord *last = &records[header->record_count - 1];
+    printf("Slowest frame: #%u, %uus\n", slowest + 1, records[slowest].duration_us);
+    printf("Last frame completed %.3fms before the dump\n", (double)(header->now_us - (last->received_us + last->duration_us)) / 1000.0);
+}
+
+
+/**
+ * @brief Get a readable name for a traced frame.
+ *
+ * @param record: Pointer to the trace record.
+ * @param name:   A buffer of at least 8 bytes for the name.
+ */
+static void frame_name(TraceRecord *record, char* name) {
+
+    if (record->length == 0) {
+        strcpy(name, "reject");
+    } else if (record->command >= PREFIX_BYTE_WRITE) {
+        sprintf(name, "W%u", record->command - PREFIX_BYTE_WRITE + 1);
+    } else if (record->command >= PREFIX_BYTE_READ) {
+        sprintf(name, "R%u", record->command - PREFIX_BYTE_READ + 1);
+    } else if (record->command >= 0x20 && record->command < 0x7F) {
+        sprintf(name, "'%c'", record->command);
+    } else {
+        sprintf(name, "0x%02X", record->command);
+    }
+}
@@ -0,0 +1,25 @@
+/*
+ * macOS/Linux UART bridge CLI utility
+ *
+ * Version 1.3.0
+ * Copyright © 2023, Tony Smith (@smittytone)
+ * Licence: MIT
+ *
+ */
+#ifndef _MAIN_H_
+#define _MAIN_H_
+
+
+/*
+ * INCLUDES
+ */
+#include <ctype.h>
+#include <sys/select.h>
+
+#include "serialdriver.h"
+#include "utils.h"
+#include "gpio.h"
+#include "uartdriver.h"
+
+
+#endif      // _MAIN_H_
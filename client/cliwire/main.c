@@ -130,8 +130,12 @@ static inline void show_commands(void) {
     fprintf(stderr, "  c {bus ID} {SDA pin} {SCL pin}   Configure 1-Wire.\n");
     fprintf(stderr, "  r {address} {count}              Read count bytes in from 1-Wire.\n");
     fprintf(stderr, "  s                                Scan for devices on the 1-Wire host.\n");
+    fprintf(stderr, "  a [family code]                  List devices in an alarm state, optionally of one family.\n");
+    fprintf(stderr, "  f {family code}                  List devices of one family, eg. 0x28 for DS18B20s.\n");
+    fprintf(stderr, "  t                                Read every DS18B20's temperature.\n");
     fprintf(stderr, "  i                                Get 1-Wire host device information.\n");
     fprintf(stderr, "  l {on|off}                       Turn the 1-Wire host LED on or off.\n");
+    fprintf(stderr, "  o {on|off} [device ID]           Set overdrive speed for all devices, or one device.\n");
     fprintf(stderr, "  h                                Show help and quit.\n");
 }
 
@@ -186,6 +190,37 @@ static int process_commands(SerialDriver *sd, int argc, char *argv[], uint32_t d
         }
 
         switch (command[0]) {
+            // FROM 1.3.0
+            case 'A':
+            case 'a':   // LIST ALARMING DEVICES
+            case 'F':
+            case 'f':   // LIST DEVICES OF ONE FAMILY
+                {
+                    bool alarm_only = (command[0] == 'a' || command[0] == 'A');
+                    uint8_t family = OW_FAMILY_ANY;
+                    if (i < argc - 1) {
+                        char* endptr = NULL;
+                        char* token = argv[i + 1];
+                        long value = strtol(token, &endptr, 0);
+                        if (*endptr == '\0' && value > 0 && value < 256) {
+                            family = (uint8_t)value;
+                            i++;
+                        }
+                    }
+
+                    if (!alarm_only && family == OW_FAMILY_ANY) {
+                        print_error("No family code given");
+                        return EXIT_ERR;
+                    }
+
+                    // IDs go to STDOUT, so they can be passed to other commands
+                    uint64_t ids[OW_DEVICE_COUNT_MAX];
+                    uint32_t id_count = one_wire_search(sd, alarm_only, family, ids, OW_DEVICE_COUNT_MAX);
+                    for (uint32_t j = 0 ; j < id_count ; ++j) fprintf(stdout, "%016llX\n", (long long unsigned int)ids[j]);
+                    if (id_count == 0) fprintf(stderr, "No matching 1-Wire devices present\n");
+                    break;
+                }
+
             case 'C':
             case 'c':   // CHOOSE 1-WIRE DATA PIN
                 {
@@ -319,6 +354,39 @@ static int process_commands(SerialDriver *sd, int argc, char *argv[], uint32_t d
                     return EXIT_ERR;
                 }
 
+            // FROM 1.3.0
+            case 'O':
+            case 'o':   // SET OVERDRIVE SPEED
+                {
+                    if (i < argc - 1) {
+                        char* token = argv[++i];
+                        bool is_on = (strcasecmp(token, "on") == 0);
+                        if (is_on || strcasecmp(token, "off") == 0) {
+                            // The device ID is optional
+                            uint64_t device_id = 0;
+                            if (is_on && i < argc - 1) {
+                                char* endptr = NULL;
+                                token = argv[i + 1];
+                                uint64_t value = strtoull(token, &endptr, 16);
+                                if (*endptr == '\0' && strlen(token) == 16) {
+                                    device_id = value;
+                                    i++;
+                                }
+                            }
+
+                            bool result = one_wire_set_overdrive(sd, is_on, device_id);
+                            if (!result) print_warning("1-Wire speed set un-ACK'd");
+                            break;
+                        }
+
+                        print_error("Invalid overdrive state given");
+                        return EXIT_ERR;
+                    }
+
+                    print_error("No overdrive state given");
+                    return EXIT_ERR;
+                }
+
             case 'R':
             case 'r':   // READ FROM THE BUS
                 {
@@ -342,6 +410,30 @@ static int process_commands(SerialDriver *sd, int argc, char *argv[], uint32_t d
                 one_wire_scan(sd);
                 break;
 
+            // FROM 1.3.0
+            case 'T':
+            case 't':   // READ EVERY DS18B20
+                {
+                    OneWireTemperature readings[OW_DEVICE_COUNT_MAX];
+                    uint8_t flags = 0;
+                    int reading_count = one_wire_read_temperatures(sd, true, readings, OW_DEVICE_COUNT_MAX, &flags);
+                    if (reading_count < 0) return EXIT_ERR;
+                    if (flags & OW_TEMP_FLAG_CONVERT_TIMEOUT) print_warning("Temperature conversion timed out");
+                    if (reading_count == 0) fprintf(stderr, "No DS18B20s present\n");
+
+                    for (int j = 0 ; j < reading_count ; ++j) {
+                        OneWireTemperature *reading = &readings[j];
+                        if (reading->status == OW_TEMP_STATUS_OK) {
+                            fprintf(stdout, "%016llX %.4f\n", (long long unsigned int)reading->rom, reading->raw_temperature / 16.0);
+                        } else {
+                            fprintf(stdout, "%016llX %s\n", (long long unsigned int)reading->rom,
+                                    reading->status == OW_TEMP_STATUS_CRC_ERROR ? "CRC-ERROR" : "NOT-PRESENT");
+                        }
+                    }
+
+                    break;
+                }
+
             case 'W':
             case 'w':   // WRITE TO THE 1-Wire BUS
                 {
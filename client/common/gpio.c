@@ -19,9 +19,9 @@
  */
 bool gpio_set_pin(SerialDriver *sd, uint8_t pin) {
 
+    // FROM 1.3.0 -- may be windowed
     uint8_t set_pin_data[2] = {'g', pin};
-    serial_write_to_port(sd->file_descriptor, set_pin_data, sizeof(set_pin_data));
-    return serial_ack(sd);
+    return serial_submit(sd, set_pin_data, sizeof(set_pin_data));
 }
 
 
@@ -36,9 +36,12 @@ bool gpio_set_pin(SerialDriver *sd, uint8_t pin) {
 uint8_t gpio_get_pin(SerialDriver *sd, uint8_t pin) {
 
     uint8_t set_pin_data[2] = {'g', pin};
+    serial_window_collect(sd);
     serial_write_to_port(sd->file_descriptor, set_pin_data, sizeof(set_pin_data));
     uint8_t pin_read = 0;
-    serial_read(sd, &pin_read, 1);
+    // The board returns the pin value directly, so there's no need
+    // to issue a read op (which the board would treat as a bus read)
+    serial_read_from_port(sd->file_descriptor, &pin_read, 1);
     return pin_read;
 }
 
@@ -53,7 +56,7 @@ uint8_t gpio_get_pin(SerialDriver *sd, uint8_t pin) {
  */
 bool gpio_clear_pin(SerialDriver *sd, uint8_t pin) {
 
+    // FROM 1.3.0 -- may be windowed
     uint8_t set_pin_data[3] = {'g', pin, 0xF0};
-    serial_write_to_port(sd->file_descriptor, set_pin_data, sizeof(set_pin_data));
-    return serial_ack(sd);
+    return serial_submit(sd, set_pin_data, sizeof(set_pin_data));
 }
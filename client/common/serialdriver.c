@@ -12,6 +12,8 @@
 #pragma mark - Static Function Prototypes
 
 static int serial_open_port(const char *portname);
+// FROM 1.3.0
+static bool serial_window_reap(SerialDriver *sd);
 
 
 #pragma mark - Globals
@@ -208,6 +210,13 @@ bool serial_write_to_port(int fd, const uint8_t* buffer, size_t byte_count) {
 void serial_flush_and_close_port(SerialDriver *sd) {
 
     if (sd->file_descriptor != -1) {
+        // FROM 1.3.0 -- collect any outstanding windowed replies
+        if (sd->is_connected && sd->window_size > 0) serial_window_close(sd);
+
+        // FROM 1.3.0 -- don't leave the board streaming samples
+        if (sd->is_connected && sd->is_sampling) serial_unsubscribe(sd);
+        if (sd->is_connected && sd->has_triggers) serial_disarm_trigger(sd, TRIGGER_ALL_PINS);
+
         // Drain the FIFOs -- alternative to `tcflush(fd, TCIOFLUSH)`;
         if (tcdrain(sd->file_descriptor) == -1) {
             print_error("Could not flush the port. %s (%d).\n", strerror(errno), errno);
@@ -245,6 +254,16 @@ void serial_connect(SerialDriver *sd, const char* device_path) {
     // Mark that we're not connected
     sd->is_connected = false;
 
+    // FROM 1.3.0 -- start in stop-and-wait mode
+    sd->window_size = 0;
+    sd->window_in_flight = 0;
+    sd->window_next_seq = 0;
+    sd->window_failed = false;
+    memset(sd->window_pending, 0, sizeof(sd->window_pending));
+    sd->is_sampling = false;
+    sd->has_triggers = false;
+    sd->i2c_bus = I2C_BUS_UNKNOWN;
+
     // Open and get the serial port or bail
     sd->file_descriptor = serial_open_port(device_path);
     if (sd->file_descriptor == -1) {
@@ -261,9 +280,10 @@ void serial_connect(SerialDriver *sd, const char* device_path) {
     uint8_t rx[4] = {0};
     size_t result = serial_read_from_port(sd->file_descriptor, rx, 4);
 
+    // FROM 1.3.0 -- store the version digits as values, not chars
     if (rx[2] != '\r') {
-        sd->fw_version_major = rx[2];
-        sd->fw_version_minor = rx[3];
+        sd->fw_version_major = rx[2] - '0';
+        sd->fw_version_minor = rx[3] - '0';
     } else {
         sd->fw_version_major = 1;
         sd->fw_version_minor = 1;
@@ -288,6 +308,10 @@ void serial_connect(SerialDriver *sd, const char* device_path) {
  */
 bool serial_ack(SerialDriver *sd) {
 
+    // FROM 1.3.0 -- replies come back in order, so
+    // collect any to frames sent ahead of this one
+    serial_window_collect(sd);
+
     uint8_t read_buffer[1] = {0};
     if (serial_read_from_port(sd->file_descriptor, read_buffer, 1) != 1) return false;
     bool ackd = ((read_buffer[0] & ACK) == ACK);
@@ -314,6 +338,7 @@ bool serial_set_mode(SerialDriver *sd, char mode_code) {
     cmd[1] = mode_code;
     serial_write_to_port(sd->file_descriptor, (uint8_t*)&cmd, 2);
 
+    // NOTE Don't window this: later frames depend on the mode
     bool success = serial_ack(sd);
     if (success) sd->board_mode = mode_code;
     return success;
@@ -374,12 +399,33 @@ bool serial_get_last_error(SerialDriver *sd) {
  */
 void serial_send_command(SerialDriver* sd, char c) {
 
+    // FROM 1.3.0 -- the reply must not be confused with windowed ones
+    serial_window_collect(sd);
     serial_write_to_port(sd->file_descriptor, (uint8_t*)&c, 1);
 }
 
 
+/**
+ * @brief Check the board's firmware is at or beyond a given version.
+ *        FROM 1.3.0
+ *
+ * @param sd:    Pointer to a SerialDriver structure.
+ * @param major: The minimum major version.
+ * @param minor: The minimum minor version.
+ *
+ * @returns Whether the firmware is recent enough (`true`) or not (`false`).
+ */
+bool serial_firmware_at_least(SerialDriver *sd, uint8_t major, uint8_t minor) {
+
+    if (sd->fw_version_major != major) return sd->fw_version_major > major;
+    return sd->fw_version_minor >= minor;
+}
+
+
 /**
  * @brief Write data to the board for transmission.
+ *        FROM 1.3.0 -- use extended frames when the firmware supports them,
+ *        so up to EXTENDED_FRAME_MAX_B bytes go out as a single bus transfer.
  *
  * @param sd:         Pointer to a SerialDriver structure.
  * @param bytes:      The bytes to write.
@@ -392,19 +438,32 @@ size_t serial_write(SerialDriver *sd, const uint8_t bytes[], size_t byte_count)
     // Count the bytes sent
     int count = 0;
     bool ack = false;
-
-    // Write the data out in blocks of 64 bytes
-    for (size_t i = 0 ; i < byte_count ; i += 64) {
-        // Calculate the data length for the prefix byte
-        size_t length = ((byte_count - i) < 64) ? (byte_count - i) : 64;
-        uint8_t write_cmd[65] = {(uint8_t)(PREFIX_BYTE_WRITE + length - 1)};
+    bool use_extended = serial_firmware_at_least(sd, 1, 3);
+    size_t block_size = use_extended ? EXTENDED_FRAME_MAX_B : 64;
+
+    // Write the data out in blocks
+    for (size_t i = 0 ; i < byte_count ; i += block_size) {
+        size_t length = ((byte_count - i) < block_size) ? (byte_count - i) : block_size;
+        uint8_t write_cmd[EXTENDED_HEADER_LENGTH_B + EXTENDED_FRAME_MAX_B];
+        size_t header_length = 1;
+
+        if (use_extended) {
+            // 'W' then the data length, little-endian
+            write_cmd[0] = EXTENDED_WRITE_CMD;
+            write_cmd[1] = (uint8_t)(length & 0xFF);
+            write_cmd[2] = (uint8_t)(length >> 8);
+            header_length = EXTENDED_HEADER_LENGTH_B;
+        } else {
+            // Calculate the data length for the prefix byte
+            write_cmd[0] = (uint8_t)(PREFIX_BYTE_WRITE + length - 1);
+        }
 
         // Write a block of bytes to the send buffer
-        memcpy(write_cmd + 1, bytes + i, length);
+        memcpy(write_cmd + header_length, bytes + i, length);
 
         // Write out the block -- use ACK as byte count
-        serial_write_to_port(sd->file_descriptor, write_cmd, 1 + length);
-        ack = serial_ack(sd);
+        // FROM 1.3.0 -- in windowed mode, this only fails on a prior ERR
+        ack = serial_submit(sd, write_cmd, header_length + length);
         if (!ack) break;
         count += length;
     }
@@ -415,6 +474,7 @@ size_t serial_write(SerialDriver *sd, const uint8_t bytes[], size_t byte_count)
 
 /**
  * @brief Read data from the board.
+ *        FROM 1.3.0 -- use extended frames when the firmware supports them.
  *
  * @param sd:         Pointer to a SerialDriver structure.
  * @param bytes:      A buffer for the bytes to read.
@@ -422,21 +482,593 @@ size_t serial_write(SerialDriver *sd, const uint8_t bytes[], size_t byte_count)
  */
 void serial_read(SerialDriver *sd, uint8_t bytes[], size_t byte_count) {
 
-    for (size_t i = 0 ; i < byte_count ; i += 64) {
-        // Calculate data length for prefix byte
-        size_t length = ((byte_count - i) < 64) ? (byte_count - i) : 64;
-        uint8_t read_cmd[1] = {(uint8_t)(PREFIX_BYTE_READ + length - 1)};
+    bool use_extended = serial_firmware_at_least(sd, 1, 3);
+    size_t block_size = use_extended ? EXTENDED_FRAME_MAX_B : 64;
 
-        serial_write_to_port(sd->file_descriptor, read_cmd, 1);
+    // FROM 1.3.0 -- the data must not be confused with windowed replies
+    serial_window_collect(sd);
+
+    for (size_t i = 0 ; i < byte_count ; i += block_size) {
+        size_t length = ((byte_count - i) < block_size) ? (byte_count - i) : block_size;
+        uint8_t read_cmd[EXTENDED_HEADER_LENGTH_B] = {(uint8_t)(PREFIX_BYTE_READ + length - 1)};
+        size_t header_length = 1;
+
+        if (use_extended) {
+            read_cmd[0] = EXTENDED_READ_CMD;
+            read_cmd[1] = (uint8_t)(length & 0xFF);
+            read_cmd[2] = (uint8_t)(length >> 8);
+            header_length = EXTENDED_HEADER_LENGTH_B;
+        }
+
+        serial_write_to_port(sd->file_descriptor, read_cmd, header_length);
         size_t result = serial_read_from_port(sd->file_descriptor, bytes + i, length);
         if (result == -1) {
             print_error("Could not read back from device");
         } else {
-            for (size_t i = 0 ; i < result ; ++i) {
-                fprintf(stdout, "%02X", bytes[i]);
+#ifndef SWIFT_BUILD
+            for (size_t j = 0 ; j < result ; ++j) {
+                fprintf(stdout, "%02X", bytes[i + j]);
             }
 
             fprintf(stdout, "\n");
+#endif
+        }
+    }
+}
+
+
+#pragma mark - Windowed Mode Functions
+
+/**
+ * @brief Allow several ACK-only frames to be in flight at once.
+ *        The board queues them and tags each reply with the frame's
+ *        sequence number. Any error is reported by `serial_drain()`.
+ *        FROM 1.3.0
+ *
+ * @param sd:          Pointer to a SerialDriver structure.
+ * @param window_size: The maximum number of frames in flight.
+ *
+ * @returns Whether the board supports windowed mode (`true`) or not (`false`).
+ */
+bool serial_window_open(SerialDriver *sd, uint8_t window_size) {
+
+    if (!serial_firmware_at_least(sd, 1, 3)) return false;
+    if (window_size > WINDOW_SIZE_MAX) window_size = WINDOW_SIZE_MAX;
+    serial_window_collect(sd);
+    sd->window_size = window_size;
+    return true;
+}
+
+
+/**
+ * @brief Wait for all frames in flight, then return to stop-and-wait mode.
+ *        FROM 1.3.0
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether all the windowed frames were ACK'd (`true`) or not (`false`).
+ */
+bool serial_window_close(SerialDriver *sd) {
+
+    bool success = serial_drain(sd);
+    sd->window_size = 0;
+    return success;
+}
+
+
+/**
+ * @brief Send a frame that the board will ACK or ERR.
+ *        In stop-and-wait mode, wait for the reply. In windowed mode, only
+ *        wait if the window is full.
+ *        FROM 1.3.0
+ *
+ * @param sd:         Pointer to a SerialDriver structure.
+ * @param frame:      The frame's bytes.
+ * @param byte_count: The frame's length.
+ *
+ * @returns Whether the frame was ACK'd (`true`) or not (`false`). In windowed
+ *          mode, `false` means an earlier frame was ERR'd.
+ */
+bool serial_submit(SerialDriver *sd, const uint8_t frame[], size_t byte_count) {
+
+    if (sd->window_size == 0) {
+        serial_write_to_port(sd->file_descriptor, frame, byte_count);
+        return serial_ack(sd);
+    }
+
+    // Make room in the window
+    while (sd->window_in_flight >= sd->window_size) {
+        if (!serial_window_reap(sd)) return false;
+    }
+
+    // Wrap the frame: '>', sequence number, 16-bit LE length, frame
+    static uint8_t envelope[WINDOW_HEADER_LENGTH_B + EXTENDED_HEADER_LENGTH_B + EXTENDED_FRAME_MAX_B];
+    if (byte_count > sizeof(envelope) - WINDOW_HEADER_LENGTH_B) return false;
+    uint8_t seq = sd->window_next_seq++;
+    envelope[0] = WINDOW_FRAME_CMD;
+    envelope[1] = seq;
+    envelope[2] = (uint8_t)(byte_count & 0xFF);
+    envelope[3] = (uint8_t)(byte_count >> 8);
+    memcpy(envelope + WINDOW_HEADER_LENGTH_B, frame, byte_count);
+
+    sd->window_pending[seq >> 3] |= (1 << (seq & 0x07));
+    sd->window_in_flight++;
+    serial_write_to_port(sd->file_descriptor, envelope, WINDOW_HEADER_LENGTH_B + byte_count);
+    return !sd->window_failed;
+}
+
+
+/**
+ * @brief Wait for all frames in flight.
+ *        FROM 1.3.0
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether all the windowed frames since the last drain were
+ *          ACK'd (`true`) or not (`false`).
+ */
+bool serial_drain(SerialDriver *sd) {
+
+    serial_window_collect(sd);
+    bool success = !sd->window_failed;
+    sd->window_failed = false;
+    return success;
+}
+
+
+/**
+ * @brief Read the reply to one windowed frame and match it to its sequence number.
+ *        FROM 1.3.0
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether a reply was read (`true`) or not (`false`).
+ */
+static bool serial_window_reap(SerialDriver *sd) {
+
+    uint8_t reply[2] = {0};
+    if (serial_read_from_port(sd->file_descriptor, reply, 2) != 2) {
+        // The board has gone away: give up on everything in flight
+        print_error("No reply to windowed frame");
+        memset(sd->window_pending, 0, sizeof(sd->window_pending));
+        sd->window_in_flight = 0;
+        sd->window_failed = true;
+        return false;
+    }
+
+    uint8_t seq = reply[1];
+    uint8_t mask = (1 << (seq & 0x07));
+    if ((sd->window_pending[seq >> 3] & mask) == 0) {
+        print_warning("Reply to unknown windowed frame %i", seq);
+        sd->window_failed = true;
+        return true;
+    }
+
+    sd->window_pending[seq >> 3] &= ~mask;
+    sd->window_in_flight--;
+    if (reply[0] != ACK) {
+#ifdef DEBUG
+        print_log("Windowed frame %i ERR", seq);
+#endif
+        sd->window_failed = true;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Read the replies to all frames in flight. Unlike `serial_drain()`,
+ *        this keeps any error for the next drain to report.
+ *        FROM 1.3.0
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ */
+void serial_window_collect(SerialDriver *sd) {
+
+    while (sd->window_in_flight > 0) {
+        if (!serial_window_reap(sd)) break;
+    }
+}
+
+
+#pragma mark - Transaction Program Functions
+
+/**
+ * @brief Prepare an empty transaction program.
+ *        FROM 1.3.0
+ *
+ * @param program: Pointer to a Program structure.
+ */
+void serial_program_init(Program *program) {
+
+    program->length = 0;
+    program->op_count = 0;
+    program->read_count = 0;
+    program->is_valid = true;
+    memset(program->status, PROGRAM_OP_SKIPPED, PROGRAM_OPS_MAX);
+}
+
+
+/**
+ * @brief Append an op to a transaction program. Bus drivers wrap this
+ *        for their own primitives.
+ *        FROM 1.3.0
+ *
+ * @param program: Pointer to a Program structure.
+ * @param op:      The opcode.
+ * @param address: The target's address, for I2C reads and writes.
+ * @param length:  The op's length (or delay) argument, if it takes one.
+ * @param data:    The data to write, for write ops.
+ *
+ * @returns Whether the op fitted (`true`) or not (`false`).
+ */
+bool serial_program_add(Program *program, uint8_t op, uint8_t address, size_t length, const uint8_t data[]) {
+
+    bool has_address = (op == PROGRAM_OP_I2C_WRITE || op == PROGRAM_OP_I2C_READ);
+    bool has_length = (op != PROGRAM_OP_I2C_STOP && op != PROGRAM_OP_OW_RESET);
+    bool has_data = (op == PROGRAM_OP_I2C_WRITE || op == PROGRAM_OP_OW_WRITE);
+    size_t op_length = 1 + (has_address ? 1 : 0) + (has_length ? 2 : 0) + (has_data ? length : 0);
+
+    if (!program->is_valid || program->op_count == PROGRAM_OPS_MAX || length > 0xFFFF ||
+        program->length + op_length > EXTENDED_FRAME_MAX_B || (has_data && data == NULL)) {
+        program->is_valid = false;
+        return false;
+    }
+
+    uint8_t* p = program->bytes + program->length;
+    *p++ = op;
+    if (has_address) *p++ = address;
+    if (has_length) {
+        *p++ = (uint8_t)(length & 0xFF);
+        *p++ = (uint8_t)(length >> 8);
+    }
+
+    if (has_data) memcpy(p, data, length);
+    program->length += op_length;
+    program->op_count++;
+    if (op == PROGRAM_OP_I2C_READ || op == PROGRAM_OP_OW_READ ||
+        op == PROGRAM_OP_OW_READ_CRC8 || op == PROGRAM_OP_OW_READ_CRC16) program->read_count += length;
+    return true;
+}
+
+
+/**
+ * @brief Send a transaction program to the board, which runs it in one go.
+ *        FROM 1.3.0
+ *
+ * @param sd:         Pointer to a SerialDriver structure.
+ * @param program:    Pointer to a Program structure. Its `status` array is
+ *                    filled with each op's outcome.
+ * @param read_bytes: A buffer for the bytes read by the program's read ops,
+ *                    in order. Must hold `program->read_count` bytes.
+ *
+ * @returns Whether every op succeeded (`true`) or not (`false`).
+ */
+bool serial_program_run(SerialDriver *sd, Program *program, uint8_t read_bytes[]) {
+
+    if (!serial_firmware_at_least(sd, 1, 3)) {
+        print_warning("Board firmware doesn't support transaction programs");
+        return false;
+    }
+
+    if (!program->is_valid || program->length == 0) {
+        print_error("Transaction program is empty or too long");
+        return false;
+    }
+
+    // The reply must not be confused with windowed ones
+    serial_window_collect(sd);
+
+    uint8_t header[EXTENDED_HEADER_LENGTH_B] = {PROGRAM_CMD,
+                                                (uint8_t)(program->length & 0xFF),
+                                                (uint8_t)(program->length >> 8)};
+    serial_write_to_port(sd->file_descriptor, header, sizeof(header));
+    serial_write_to_port(sd->file_descriptor, program->bytes, program->length);
+
+    // Reply is op count, per-op status, then read data
+    uint8_t op_count = 0;
+    if (serial_read_from_port(sd->file_descriptor, &op_count, 1) != 1) return false;
+    if (op_count == ERR || op_count != program->op_count) {
+        print_error("Board rejected transaction program");
+        return false;
+    }
+
+    if (serial_read_from_port(sd->file_descriptor, program->status, op_count) != op_count) return false;
+
+    // Only successful reads return data, so size the data from the status
+    bool success = true;
+    size_t data_count = 0;
+    size_t index = 0;
+    for (uint8_t i = 0 ; i < op_count ; ++i) {
+        uint8_t op = program->bytes[index];
+        size_t op_length = 1;
+        size_t length = 0;
+        if (op == PROGRAM_OP_I2C_WRITE || op == PROGRAM_OP_I2C_READ) op_length++;
+        if (op != PROGRAM_OP_I2C_STOP && op != PROGRAM_OP_OW_RESET) {
+            length = program->bytes[index + op_length] | (program->bytes[index + op_length + 1] << 8);
+            op_length += 2;
+        }
+
+        if (op == PROGRAM_OP_I2C_WRITE || op == PROGRAM_OP_OW_WRITE) op_length += length;
+        if (program->status[i] != 0x00) {
+            success = false;
+        } else if (op == PROGRAM_OP_I2C_READ || op == PROGRAM_OP_OW_READ ||
+                   op == PROGRAM_OP_OW_READ_CRC8 || op == PROGRAM_OP_OW_READ_CRC16) {
+            data_count += length;
         }
+
+        index += op_length;
+    }
+
+    if (data_count > 0 && serial_read_from_port(sd->file_descriptor, read_bytes, data_count) != data_count) return false;
+    return success;
+}
+
+
+#pragma mark - Status Functions
+
+/**
+ * @brief Get the board's binary status record.
+ *        FROM 1.3.0
+ *
+ * @param sd:     Pointer to a SerialDriver structure.
+ * @param status: Pointer to a StatusRecord to fill.
+ *
+ * @returns Whether the record was read (`true`) or not (`false`).
+ */
+bool serial_get_status(SerialDriver *sd, StatusRecord *status) {
+
+    if (!serial_firmware_at_least(sd, 1, 3)) return false;
+
+    uint8_t record[sizeof(StatusRecord)];
+    serial_send_command(sd, STATUS_CMD);
+    if (serial_read_from_port(sd->file_descriptor, record, sizeof(record)) != sizeof(record)) {
+        print_error("Could not read status from device");
+        return false;
+    }
+
+    memcpy(status, record, sizeof(StatusRecord));
+    return status->record_version == STATUS_RECORD_VERSION;
+}
+
+
+/**
+ * @brief Get the board's performance counters.
+ *        FROM 1.3.0
+ *
+ * @param sd:       Pointer to a SerialDriver structure.
+ * @param do_clear: Have the board zero its counters after sending them.
+ * @param header:   Pointer to a PerfHeader to fill.
+ * @param slots:    An array of PERF_COMMAND_SLOTS PerfSlots to fill.
+ *                  `header->slot_count` of them are set.
+ *
+ * @returns Whether the record was read (`true`) or not (`false`).
+ */
+bool serial_get_perf(SerialDriver *sd, bool do_clear, PerfHeader *header, PerfSlot slots[]) {
+
+    if (!serial_firmware_at_least(sd, 1, 3)) return false;
+
+    uint8_t perf_data[2] = {PERF_CMD, (do_clear ? PERF_FLAG_RESET : 0)};
+    serial_window_collect(sd);
+    serial_write_to_port(sd->file_descriptor, perf_data, sizeof(perf_data));
+
+    if (serial_read_from_port(sd->file_descriptor, (uint8_t*)header, sizeof(PerfHeader)) != sizeof(PerfHeader)) {
+        print_error("Could not read performance counters from device");
+        return false;
+    }
+
+    if (header->record_version != PERF_RECORD_VERSION || header->slot_count > PERF_COMMAND_SLOTS) return false;
+
+    size_t byte_count = header->slot_count * sizeof(PerfSlot);
+    if (byte_count > 0 && serial_read_from_port(sd->file_descriptor, (uint8_t*)slots, byte_count) != byte_count) {
+        print_error("Could not read performance counters from device");
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Get the board's command trace.
+ *        FROM 1.3.0
+ *
+ * @param sd:       Pointer to a SerialDriver structure.
+ * @param do_clear: Have the board clear its trace after sending it.
+ * @param header:   Pointer to a TraceHeader to fill.
+ * @param records:  An array of TRACE_RECORD_COUNT_MAX TraceRecords to fill.
+ *                  `header->record_count` of them are set, oldest first.
+ *
+ * @returns Whether the trace was read (`true`) or not (`false`).
+ */
+bool serial_get_trace(SerialDriver *sd, bool do_clear, TraceHeader *header, TraceRecord records[]) {
+
+    if (!serial_firmware_at_least(sd, 1, 3)) return false;
+
+    uint8_t trace_data[2] = {TRACE_CMD, (do_clear ? TRACE_FLAG_CLEAR : 0)};
+    serial_window_collect(sd);
+    serial_write_to_port(sd->file_descriptor, trace_data, sizeof(trace_data));
+
+    if (serial_read_from_port(sd->file_descriptor, (uint8_t*)header, sizeof(TraceHeader)) != sizeof(TraceHeader)) {
+        print_error("Could not read trace from device");
+        return false;
     }
+
+    if (header->record_version != TRACE_RECORD_VERSION ||
+        header->record_size != sizeof(TraceRecord) ||
+        header->record_count > TRACE_RECORD_COUNT_MAX) return false;
+
+    size_t byte_count = header->record_count * sizeof(TraceRecord);
+    if (byte_count > 0 && serial_read_from_port(sd->file_descriptor, (uint8_t*)records, byte_count) != byte_count) {
+        print_error("Could not read trace from device");
+        return false;
+    }
+
+    return true;
+}
+
+
+#pragma mark - Sampling Functions
+
+/**
+ * @brief Have the board run a transaction program every period, and
+ *        stream the results. Collect them with `serial_next_sample()`.
+ *        Until `serial_unsubscribe()` is called, the board's output is
+ *        the sample stream, so send no other commands.
+ *        FROM 1.3.0
+ *
+ * @param sd:        Pointer to a SerialDriver structure.
+ * @param period_ms: The sampling period in milliseconds.
+ * @param program:   Pointer to the program to run. It may be no longer
+ *                   than SAMPLE_PROGRAM_MAX_B.
+ *
+ * @returns Whether the board started the job (`true`) or not (`false`).
+ */
+bool serial_subscribe(SerialDriver *sd, uint16_t period_ms, Program *program) {
+
+    if (!serial_firmware_at_least(sd, 1, 3)) return false;
+    if (sd->is_sampling || period_ms == 0 || !program->is_valid || program->length == 0 || program->length > SAMPLE_PROGRAM_MAX_B) return false;
+
+    uint8_t frame[EXTENDED_HEADER_LENGTH_B + 2 + SAMPLE_PROGRAM_MAX_B];
+    size_t data_length = 2 + program->length;
+    frame[0] = SAMPLE_CMD;
+    frame[1] = (uint8_t)(data_length & 0xFF);
+    frame[2] = (uint8_t)(data_length >> 8);
+    frame[3] = (uint8_t)(period_ms & 0xFF);
+    frame[4] = (uint8_t)(period_ms >> 8);
+    memcpy(&frame[5], program->bytes, program->length);
+
+    serial_window_collect(sd);
+    serial_write_to_port(sd->file_descriptor, frame, EXTENDED_HEADER_LENGTH_B + data_length);
+    sd->is_sampling = serial_ack(sd);
+    return sd->is_sampling;
+}
+
+
+/**
+ * @brief Wait for the next record streamed by a sampling job or pin trigger.
+ *        FROM 1.3.0
+ *
+ * @param sd:       Pointer to a SerialDriver structure.
+ * @param header:   Pointer to a SampleHeader to fill.
+ * @param data:     A buffer for the bytes the sample read.
+ * @param data_max: The buffer's size in bytes.
+ *
+ * @returns Whether a record was read (`true`) or not (`false`), eg. on a
+ *          timeout. Periods longer than READ_BUS_HOST_TIMEOUT_S time out
+ *          between samples: just call again.
+ */
+bool serial_next_sample(SerialDriver *sd, SampleHeader *header, uint8_t data[], size_t data_max) {
+
+    if (serial_read_from_port(sd->file_descriptor, (uint8_t*)header, sizeof(SampleHeader)) != sizeof(SampleHeader)) return false;
+
+    if (header->marker != SAMPLE_MARKER) {
+        print_error("Sample stream out of sync");
+        return false;
+    }
+
+    if (header->length > data_max) {
+        print_error("Sample too large for buffer");
+        return false;
+    }
+
+    if (header->length > 0 && serial_read_from_port(sd->file_descriptor, data, header->length) != header->length) return false;
+    if ((header->flags & (SAMPLE_FLAG_STOPPED | SAMPLE_FLAG_TRIGGER)) == SAMPLE_FLAG_STOPPED) sd->is_sampling = false;
+    return true;
+}
+
+
+/**
+ * @brief Stop the board's sampling job, discarding any samples still
+ *        in transit.
+ *        FROM 1.3.0
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether the board confirmed the job has stopped (`true`) or not (`false`).
+ */
+bool serial_unsubscribe(SerialDriver *sd) {
+
+    uint8_t frame[EXTENDED_HEADER_LENGTH_B] = {SAMPLE_CMD, 0, 0};
+    serial_write_to_port(sd->file_descriptor, frame, EXTENDED_HEADER_LENGTH_B);
+
+    // The board ends the stream with a record flagged SAMPLE_FLAG_STOPPED
+    SampleHeader header;
+    uint8_t data[EXTENDED_FRAME_MAX_B];
+    for (uint32_t i = 0 ; i < SAMPLE_STOP_RECORDS_MAX ; ++i) {
+        if (!serial_next_sample(sd, &header, data, sizeof(data))) break;
+        if ((header.flags & (SAMPLE_FLAG_STOPPED | SAMPLE_FLAG_TRIGGER)) == SAMPLE_FLAG_STOPPED) return true;
+    }
+
+    print_error("Sampling job did not stop");
+    return false;
+}
+
+
+/**
+ * @brief Have the board run a transaction program whenever a pin sees a
+ *        chosen edge, and stream the results, timestamped with the edge.
+ *        Collect them with `serial_next_sample()`: they are flagged
+ *        SAMPLE_FLAG_TRIGGER. Until the trigger is disarmed, the board's
+ *        output includes these records, so send no other commands.
+ *        FROM 1.3.0
+ *
+ * @param sd:      Pointer to a SerialDriver structure.
+ * @param pin:     The GPIO pin to watch.
+ * @param edges:   TRIGGER_EDGE_* and, optionally, TRIGGER_PULL_* values.
+ * @param program: Pointer to the program to run. It may be no longer
+ *                 than SAMPLE_PROGRAM_MAX_B.
+ *
+ * @returns Whether the board armed the trigger (`true`) or not (`false`).
+ */
+bool serial_arm_trigger(SerialDriver *sd, uint8_t pin, uint8_t edges, Program *program) {
+
+    if (!serial_firmware_at_least(sd, 1, 3)) return false;
+    if (!program->is_valid || program->length == 0 || program->length > SAMPLE_PROGRAM_MAX_B) return false;
+
+    uint8_t frame[EXTENDED_HEADER_LENGTH_B + 2 + SAMPLE_PROGRAM_MAX_B];
+    size_t data_length = 2 + program->length;
+    frame[0] = TRIGGER_CMD;
+    frame[1] = (uint8_t)(data_length & 0xFF);
+    frame[2] = (uint8_t)(data_length >> 8);
+    frame[3] = pin;
+    frame[4] = edges;
+    memcpy(&frame[5], program->bytes, program->length);
+
+    serial_window_collect(sd);
+    serial_write_to_port(sd->file_descriptor, frame, EXTENDED_HEADER_LENGTH_B + data_length);
+    if (!serial_ack(sd)) return false;
+    sd->has_triggers = true;
+    return true;
+}
+
+
+/**
+ * @brief Disarm a pin trigger, discarding any records still in transit.
+ *        FROM 1.3.0
+ *
+ * @param sd:  Pointer to a SerialDriver structure.
+ * @param pin: The trigger's pin, or TRIGGER_ALL_PINS.
+ *
+ * @returns Whether the board confirmed the trigger is disarmed (`true`) or not (`false`).
+ */
+bool serial_disarm_trigger(SerialDriver *sd, uint8_t pin) {
+
+    uint8_t frame[EXTENDED_HEADER_LENGTH_B + 1] = {TRIGGER_CMD, 1, 0, pin};
+    serial_write_to_port(sd->file_descriptor, frame, sizeof(frame));
+
+    // The board confirms with a record flagged SAMPLE_FLAG_TRIGGER | SAMPLE_FLAG_STOPPED
+    SampleHeader header;
+    uint8_t data[EXTENDED_FRAME_MAX_B];
+    for (uint32_t i = 0 ; i < SAMPLE_STOP_RECORDS_MAX ; ++i) {
+        if (!serial_next_sample(sd, &header, data, sizeof(data))) break;
+        if ((header.flags & (SAMPLE_FLAG_STOPPED | SAMPLE_FLAG_TRIGGER)) == (SAMPLE_FLAG_STOPPED | SAMPLE_FLAG_TRIGGER) && header.pin == pin) {
+            if (pin == TRIGGER_ALL_PINS) sd->has_triggers = false;
+            return true;
+        }
+    }
+
+    print_error("Pin trigger was not disarmed");
+    return false;
 }
@@ -65,6 +65,62 @@
 #define     MODE_CODE_UART              'u'
 #define     MODE_CODE_ONE_WIRE          'o'
 
+// FROM 1.3.0
+#define EXTENDED_WRITE_CMD              'W'
+#define EXTENDED_READ_CMD               'R'
+#define EXTENDED_HEADER_LENGTH_B        3
+#define EXTENDED_FRAME_MAX_B            4096
+#define WINDOW_FRAME_CMD                '>'
+#define WINDOW_HEADER_LENGTH_B          4
+#define WINDOW_SIZE_MAX                 32
+#define WINDOW_SIZE_DEFAULT             8
+#define PROGRAM_CMD                     'T'
+#define PROGRAM_OPS_MAX                 32
+#define PROGRAM_OP_SKIPPED              0xFF
+#define PROGRAM_OP_I2C_WRITE            0x01
+#define PROGRAM_OP_I2C_READ             0x02
+#define PROGRAM_OP_I2C_STOP             0x03
+#define PROGRAM_OP_OW_RESET             0x10
+#define PROGRAM_OP_OW_WRITE             0x11
+#define PROGRAM_OP_OW_READ              0x12
+#define PROGRAM_OP_OW_READ_CRC8         0x13
+#define PROGRAM_OP_OW_READ_CRC16        0x14
+#define PROGRAM_OP_DELAY                0x20
+#define STATUS_CMD                      'q'
+#define STATUS_RECORD_VERSION           1
+#define STATUS_FLAG_READY               0x01
+#define STATUS_FLAG_STARTED             0x02
+#define STATUS_FLAG_OVERDRIVE           0x04
+#define BOARD_ID_LENGTH_B               8
+#define MODEL_NAME_LENGTH_B             24
+#define PERF_CMD                        'm'
+#define PERF_RECORD_VERSION             1
+#define PERF_FLAG_RESET                 0x01
+#define PERF_COMMAND_SLOTS              130
+#define PERF_HISTOGRAM_BUCKETS          20
+#define TRACE_CMD                       'L'
+#define TRACE_RECORD_VERSION            1
+#define TRACE_FLAG_CLEAR                0x01
+#define TRACE_RECORD_COUNT_MAX          256
+#define TRACE_NO_SEQUENCE               0xFF
+#define TRACE_BUS_FLAG_READY            0x01
+#define TRACE_BUS_FLAG_STARTED          0x02
+#define SAMPLE_CMD                      'J'
+#define SAMPLE_PROGRAM_MAX_B            256
+#define SAMPLE_MARKER                   0xA5
+#define SAMPLE_FLAG_ERROR               0x01
+#define SAMPLE_FLAG_OVERRUN             0x02
+#define SAMPLE_FLAG_STOPPED             0x04
+#define SAMPLE_FLAG_TRIGGER             0x08
+#define TRIGGER_CMD                     'G'
+#define TRIGGER_EDGE_RISE               0x01
+#define TRIGGER_EDGE_FALL               0x02
+#define TRIGGER_PULL_UP                 0x04
+#define TRIGGER_PULL_DOWN               0x08
+#define TRIGGER_ALL_PINS                0xFF
+#define SAMPLE_STOP_RECORDS_MAX         64
+#define I2C_BUS_UNKNOWN                 0xFF
+
 
 /*
  * STRUCTURES
@@ -75,8 +131,107 @@ typedef struct {
     char            board_mode;         // Current bus mode
     uint8_t         fw_version_major;
     uint8_t         fw_version_minor;
+    // FROM 1.3.0 -- windowed mode
+    uint8_t         window_size;        // Frames allowed in flight; 0 for stop-and-wait
+    uint8_t         window_in_flight;   // Frames sent but not yet ACK'd or ERR'd
+    uint8_t         window_next_seq;    // Sequence number for the next frame
+    bool            window_failed;      // A windowed frame was ERR'd since the last drain
+    uint8_t         window_pending[32]; // Bitmap of in-flight sequence numbers
+    bool            is_sampling;        // A sampling job is streaming records
+    bool            has_triggers;       // Pin triggers may be streaming records
+    uint8_t         i2c_bus;            // The I2C controller selected on the board, or I2C_BUS_UNKNOWN
 } SerialDriver;
 
+// FROM 1.3.0
+typedef struct {
+    uint8_t         bytes[EXTENDED_FRAME_MAX_B];
+    size_t          length;             // Program length in bytes
+    uint8_t         op_count;
+    size_t          read_count;         // Bytes the program's reads will return
+    bool            is_valid;           // Cleared if an op didn't fit
+    uint8_t         status[PROGRAM_OPS_MAX];    // Per-op outcome, set by running the program
+} Program;
+
+// FROM 1.3.0
+// Binary status record, as sent by the board: packed and little-endian
+typedef struct __attribute__((packed)) {
+    uint8_t         record_version;
+    uint8_t         mode;
+    uint8_t         fw_major;
+    uint8_t         fw_minor;
+    uint8_t         fw_patch;
+    uint16_t        build_number;
+    uint8_t         board_id[BOARD_ID_LENGTH_B];
+    char            model[MODEL_NAME_LENGTH_B];     // Not NUL-terminated if full
+    uint8_t         flags;
+    uint8_t         bus;                // I2C bus ID
+    uint8_t         pins[2];            // I2C SDA and SCL, or 1-Wire data
+    uint8_t         address;            // Target I2C address
+    uint16_t        frequency_khz;      // I2C bus frequency
+    uint8_t         device_count;       // 1-Wire devices found
+    uint8_t         last_error;
+} StatusRecord;
+
+// FROM 1.3.0
+// Performance record, as sent by the board: this header, then
+// `slot_count` PerfSlots. Packed and little-endian
+typedef struct __attribute__((packed)) {
+    uint8_t         record_version;
+    uint8_t         slot_count;
+    uint8_t         bucket_count;
+    uint8_t         reserved;
+    uint32_t        elapsed_ms;         // Since the counters were cleared
+    uint32_t        rejected_frames;
+    uint32_t        i2c_bytes_written;
+    uint32_t        i2c_bytes_read;
+    uint32_t        i2c_nak_count;
+    uint32_t        i2c_timeout_count;
+    uint32_t        ow_bytes_written;
+    uint32_t        ow_bytes_read;
+} PerfHeader;
+
+typedef struct __attribute__((packed)) {
+    uint8_t         command;            // ASCII command, PREFIX_BYTE_READ or PREFIX_BYTE_WRITE
+    uint32_t        count;
+    uint32_t        latency[PERF_HISTOGRAM_BUCKETS];    // Bucket n: 2^(n-1) to 2^n - 1us
+} PerfSlot;
+
+// FROM 1.3.0
+// Command trace, as sent by the board: this header, then `record_count`
+// TraceRecords, oldest first. Packed and little-endian
+typedef struct __attribute__((packed)) {
+    uint8_t         record_version;
+    uint8_t         record_size;
+    uint16_t        record_count;
+    uint32_t        dropped_count;      // Records overwritten since the trace was cleared
+    uint32_t        now_us;             // Board time at the dump
+} TraceHeader;
+
+typedef struct __attribute__((packed)) {
+    uint32_t        received_us;        // Board time at receipt, low 32 bits
+    uint32_t        duration_us;        // Receipt to reply
+    uint16_t        length;             // Frame length; 0 if the board rejected it
+    uint8_t         command;            // The frame's first byte
+    uint8_t         sequence;           // Window sequence number, or TRACE_NO_SEQUENCE
+    uint8_t         result;             // Board error code, or 0
+    uint8_t         mode;
+    uint8_t         bus_flags;
+    uint8_t         reserved;
+} TraceRecord;
+
+// FROM 1.3.0
+// Streamed by a sampling job or pin trigger: this header, then `length` bytes
+// read by the job's program. Packed and little-endian
+typedef struct __attribute__((packed)) {
+    uint8_t         marker;             // SAMPLE_MARKER
+    uint8_t         flags;
+    uint8_t         error;              // Board error code if SAMPLE_FLAG_ERROR is set
+    uint8_t         pin;                // The trigger's pin if SAMPLE_FLAG_TRIGGER is set
+    uint32_t        timestamp_us;       // Board time the sample was due, or the edge came, low 32 bits
+    uint16_t        sequence;
+    uint16_t        length;
+} SampleHeader;
+
 
 /*
  * PROTOTYPES
@@ -98,6 +253,24 @@ void            serial_read(SerialDriver *sd, uint8_t bytes[], size_t byte_count
 
 bool            serial_ack(SerialDriver *sd);
 void            serial_send_command(SerialDriver *sd, char c);
+// FROM 1.3.0
+bool            serial_firmware_at_least(SerialDriver *sd, uint8_t major, uint8_t minor);
+bool            serial_window_open(SerialDriver *sd, uint8_t window_size);
+bool            serial_window_close(SerialDriver *sd);
+bool            serial_submit(SerialDriver *sd, const uint8_t frame[], size_t byte_count);
+bool            serial_drain(SerialDriver *sd);
+void            serial_window_collect(SerialDriver *sd);
+void            serial_program_init(Program *program);
+bool            serial_program_add(Program *program, uint8_t op, uint8_t address, size_t length, const uint8_t data[]);
+bool            serial_program_run(SerialDriver *sd, Program *program, uint8_t read_bytes[]);
+bool            serial_get_status(SerialDriver *sd, StatusRecord *status);
+bool            serial_get_perf(SerialDriver *sd, bool do_clear, PerfHeader *header, PerfSlot slots[]);
+bool            serial_get_trace(SerialDriver *sd, bool do_clear, TraceHeader *header, TraceRecord records[]);
+bool            serial_subscribe(SerialDriver *sd, uint16_t period_ms, Program *program);
+bool            serial_next_sample(SerialDriver *sd, SampleHeader *header, uint8_t data[], size_t data_max);
+bool            serial_unsubscribe(SerialDriver *sd);
+bool            serial_arm_trigger(SerialDriver *sd, uint8_t pin, uint8_t edges, Program *program);
+bool            serial_disarm_trigger(SerialDriver *sd, uint8_t pin);
 
 
 #endif  // _SERIAL_DRIVER_H
@@ -130,6 +130,11 @@ if (board.is_connected) {
     
     var result: [UInt8] = [0, 0]
     
+    // FROM 1.3.0 -- storage for the board's bulk readings
+    let useBulkRead: Bool = serial_firmware_at_least(&board, 1, 3)
+    var readings: [OneWireTemperature] = [OneWireTemperature](repeating: OneWireTemperature(), count: Int(OW_DEVICE_COUNT_MAX))
+    var readFlags: UInt8 = 0
+    
     // Start 1-Wire
     if !one_wire_init(&board) {
         reportErrorAndExit("Could not initialise 1-Wire... exiting")
@@ -138,6 +143,30 @@ if (board.is_connected) {
     report("Starting...")
     
     while true {
+        // FROM 1.3.0 -- have the board convert and read every sensor in one go
+        if useBulkRead {
+            let readingCount: Int32 = one_wire_read_temperatures(&board, true, &readings, UInt32(OW_DEVICE_COUNT_MAX), &readFlags)
+            if readingCount < 0 {
+                reportErrorAndExit("Could not read the sensors")
+            }
+            
+            var outputString: String = "\r"
+            for i in 0..<Int(readingCount) {
+                if Int32(readings[i].status) == OW_TEMP_STATUS_OK {
+                    outputString += String(format: "%02X: %.2f°C   ", UInt8(readings[i].rom >> 8 & 0xFF), Float(readings[i].raw_temperature) * 0.0625)
+                } else {
+                    outputString += String(format: "%02X: --.--°C   ", UInt8(readings[i].rom >> 8 & 0xFF))
+                }
+            }
+            
+            if let outputData: Data = outputString.data(using: .utf8) {
+                STD_OUT.write(outputData)
+            }
+            
+            sleep(READING_INTERVAL_S)
+            continue
+        }
+        
         // Send the convert command
         one_wire_reset(&board)
         one_wire_write_bytes(&board, &cmd_bytes_convert, 2)
@@ -83,7 +83,11 @@ bool i2c_set_bus(SerialDriver *sd, uint8_t bus_id, uint8_t sda_pin, uint8_t scl_
     if (bus_id < 0 || bus_id > 1) return false;
     uint8_t set_bus_data[4] = {'c', (bus_id & 0x01), sda_pin, scl_pin};
     serial_write_to_port(sd->file_descriptor, set_bus_data, sizeof(set_bus_data));
-    return serial_ack(sd);
+    bool result = serial_ack(sd);
+
+    // FROM 1.3.0 -- the board also selects the bus it has configured
+    if (result && serial_firmware_at_least(sd, 1, 3)) sd->i2c_bus = bus_id;
+    return result;
 }
 
 
@@ -101,6 +105,32 @@ bool i2c_reset(SerialDriver *sd) {
 }
 
 
+/**
+ * @brief Choose which of the I2C host's controllers subsequent I2C
+ *        commands use. Each keeps its own pins, speed and transaction
+ *        state, so both can be initialised and used in turn without
+ *        reconfiguring. Nothing is sent if the bus is already selected.
+ *        FROM 1.3.0
+ *
+ * @param sd:     Pointer to a SerialDriver structure.
+ * @param bus_id: The Pico SDK I2C bus ID: 0 or 1.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`). In
+ *          windowed mode, `false` means an earlier frame was ERR'd.
+ */
+bool i2c_select_bus(SerialDriver *sd, uint8_t bus_id) {
+
+    if (bus_id > 1 || !serial_firmware_at_least(sd, 1, 3)) return false;
+    if (sd->i2c_bus == bus_id) return true;
+
+    // May be windowed, so it costs no round trip
+    uint8_t select_data[2] = {I2C_BUS_CMD, bus_id};
+    bool result = serial_submit(sd, select_data, sizeof(select_data));
+    sd->i2c_bus = result ? bus_id : I2C_BUS_UNKNOWN;
+    return result;
+}
+
+
 #pragma mark - I2C Information Functions
 
 /**
@@ -111,6 +141,36 @@ bool i2c_reset(SerialDriver *sd) {
  */
 void i2c_get_info(SerialDriver *sd, bool do_print) {
 
+    // FROM 1.3.0 -- use the binary status record if we can
+    StatusRecord status;
+    if (serial_get_status(sd, &status)) {
+        char pid[2 * BOARD_ID_LENGTH_B + 1] = {0};
+        char model[MODEL_NAME_LENGTH_B + 1] = {0};
+        for (int i = 0 ; i < BOARD_ID_LENGTH_B ; ++i) sprintf(&pid[i * 2], "%02X", status.board_id[i]);
+        memcpy(model, status.model, MODEL_NAME_LENGTH_B);
+        i2c.speed = status.frequency_khz;
+
+        if (do_print) {
+            print_log("   I2C host device: %s", model);
+            print_log( "  I2C host version: %i.%i.%i (%i)", status.fw_major, status.fw_minor, status.fw_patch, status.build_number);
+            print_log("       I2C host ID: %s", pid);
+            print_log("     Using I2C bus: %s", status.bus == 0 ? "i2c0" : "i2c1");
+            print_log(" I2C bus frequency: %ikHz", status.frequency_khz);
+            print_log(" Pins used for I2C: GP%i (SDA), GP%i (SCL)", status.pins[0], status.pins[1]);
+            print_log("    I2C is enabled: %s", (status.flags & STATUS_FLAG_READY) ? "YES" : "NO");
+            print_log("     I2C is active: %s", (status.flags & STATUS_FLAG_STARTED) ? "YES" : "NO");
+
+            // Check for a 'no device' I2C address
+            if (status.address == 0xFF) {
+                print_log("Target I2C address: NONE");
+            } else {
+                print_log("Target I2C address: 0x%02X", status.address);
+            }
+        }
+
+        return;
+    }
+
     uint8_t read_buffer[HOST_INFO_BUFFER_MAX_B] = {0};
     serial_send_command(sd, '?');
     size_t result = serial_read_from_port(sd->file_descriptor, read_buffer, 0);
@@ -186,55 +246,116 @@ void i2c_get_info(SerialDriver *sd, bool do_print) {
 
 
 /**
- * @brief Scan the I2C bus and list devices.
+ * @brief Scan the I2C bus for devices.
+ *        FROM 1.3.0 -- boards on 1.3 and up return a presence bitmap;
+ *        older boards' address lists are converted to one.
  *
- * @param sd: Pointer to a SerialDriver structure.
+ * @param sd:     Pointer to a SerialDriver structure.
+ * @param bitmap: An I2C_SCAN_BITMAP_LENGTH_B-byte buffer. Bit (address % 8)
+ *                of byte (address / 8) is set if a device is present.
+ *
+ * @returns Whether the scan succeeded (`true`) or not (`false`).
  */
-void i2c_scan(SerialDriver *sd) {
+bool i2c_scan_bitmap(SerialDriver *sd, uint8_t bitmap[]) {
 
-    char scan_buffer[SCAN_BUFFER_MAX_B] = {0};
-    uint8_t device_list[CONNECTED_DEVICES_MAX_B] = {0};
-    uint32_t device_count = 0;
+    memset(bitmap, 0, I2C_SCAN_BITMAP_LENGTH_B);
+
+    if (serial_firmware_at_least(sd, 1, 3)) {
+        serial_send_command(sd, 'D');
+        if (serial_read_from_port(sd->file_descriptor, bitmap, I2C_SCAN_BITMAP_LENGTH_B) != I2C_SCAN_BITMAP_LENGTH_B) {
+            print_error("Could not read scan data from device");
+            return false;
+        }
+
+        return true;
+    }
 
     // Request scan from bus host
+    char scan_buffer[SCAN_BUFFER_MAX_B] = {0};
     serial_send_command(sd, 'd');
     size_t result = serial_read_from_port(sd->file_descriptor, (uint8_t*)scan_buffer, 0);
     if (result == -1) {
         print_error("Could not read scan data from device");
-        return;
+        return false;
     }
 
-    // If we receive Z(ero), there are no connected devices
+    // If we receive Z(ero), there are no connected devices.
+    // Otherwise extract the device addresses, eg. "12.71.A0."
     if (scan_buffer[0] != 'Z') {
-        // Extract device address hex strings and generate
-        // integer values. For example:
-        // source = "12.71.A0."
-        // dest   = [18, 113, 160]
+        char* cursor = scan_buffer;
+        while (*cursor != '\0') {
+            char* end = cursor;
+            long address = strtol(cursor, &end, 16);
+            if (end == cursor || *end != '.') break;
+            if (address >= 0 && address < 0x80) bitmap[address >> 3] |= (1 << (address & 0x07));
+            cursor = end + 1;
+        }
+    }
 
-#ifdef DEBUG
-        print_log("Buffer: %lu bytes, %lu items", strlen(scan_buffer), strlen(scan_buffer) / 3);
-#endif
+    return true;
+}
 
-        for (uint32_t i = 0 ; i < strlen(scan_buffer) ; i += 3) {
 
-            uint8_t value[2] = {0};
-            uint32_t count = 0;
+/**
+ * @brief Scan a range of I2C addresses, on one or both of the board's
+ *        controllers at once.
+ *        FROM 1.3.0
+ *
+ * @param sd:         Pointer to a SerialDriver structure.
+ * @param first:      The first address to probe.
+ * @param last:       The last address to probe.
+ * @param timeout_us: The per-probe timeout, or 0 for the board's default.
+ * @param flags:      I2C_SCAN_FLAG_WRITE_PROBE to probe with writes (a single
+ *                    0x00 byte) rather than reads; I2C_SCAN_FLAG_BOTH_BUSES to
+ *                    scan the other controller too, if it's active.
+ * @param bitmaps:    Buffers for the i2c0 and i2c1 presence bitmaps.
+ * @param result:     Set to I2C_SCAN_RESULT_* flags: which buses were scanned,
+ *                    and which were abandoned because the bus was stuck.
+ *
+ * @returns Whether the scan ran (`true`) or not (`false`).
+ */
+bool i2c_fast_scan(SerialDriver *sd, uint8_t first, uint8_t last, uint16_t timeout_us, uint8_t flags,
+                   uint8_t bitmaps[2][I2C_SCAN_BITMAP_LENGTH_B], uint8_t *result) {
+
+    memset(bitmaps, 0, 2 * I2C_SCAN_BITMAP_LENGTH_B);
+    *result = 0;
+    if (!serial_firmware_at_least(sd, 1, 3)) {
+        print_warning("Board firmware doesn't support fast scans");
+        return false;
+    }
 
-            // Get two hex chars and store in 'value'; break on a .
-            while(1) {
-                uint8_t token = scan_buffer[i + count];
-                if (token == 0x2E) break;
-                value[count] = token;
-                count++;
-            }
+    uint8_t scan_cmd[6] = {'E', first, last, (uint8_t)(timeout_us & 0xFF), (uint8_t)(timeout_us >> 8), flags};
+    serial_window_collect(sd);
+    serial_write_to_port(sd->file_descriptor, scan_cmd, sizeof(scan_cmd));
 
-            device_list[device_count] = (uint8_t)strtol((char *)value, NULL, 16);
-            device_count++;
+    if (serial_read_from_port(sd->file_descriptor, result, 1) != 1 || *result == ERR) {
+        print_error("Could not read scan data from device");
+        return false;
+    }
+
+    for (int i = 0 ; i < 2 ; ++i) {
+        if ((*result & (i == 0 ? I2C_SCAN_RESULT_BUS_0 : I2C_SCAN_RESULT_BUS_1)) == 0) continue;
+        if (serial_read_from_port(sd->file_descriptor, bitmaps[i], I2C_SCAN_BITMAP_LENGTH_B) != I2C_SCAN_BITMAP_LENGTH_B) {
+            print_error("Could not read scan data from device");
+            return false;
         }
     }
 
-    // Output the device list as a table (even with no devices)
+    return true;
+}
+
 
+/**
+ * @brief Scan the I2C bus and output the results as a table.
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ */
+void i2c_scan(SerialDriver *sd) {
+
+    uint8_t bitmap[I2C_SCAN_BITMAP_LENGTH_B];
+    if (!i2c_scan_bitmap(sd, bitmap)) return;
+
+    // Output the device list as a table (even with no devices)
     fprintf(stderr, "   0 1 2 3 4 5 6 7 8 9 A B C D E F");
 
     for (int i = 0 ; i < 0x80 ; i++) {
@@ -242,19 +363,7 @@ void i2c_scan(SerialDriver *sd) {
         if (i < 8 || i > 0x77) {
             fprintf(stderr, "  ");
         } else {
-            bool found = false;
-
-            if (device_count > 0) {
-                for (int j = 0 ; j < 120 ; j++) {
-                    if (device_list[j] == i) {
-                        fprintf(stderr, "@ ");
-                        found = true;
-                        break;
-                    }
-                }
-            }
-
-            if (!found) fprintf(stderr, ". ");
+            fprintf(stderr, (bitmap[i >> 3] & (1 << (i & 0x07))) ? "@ " : ". ");
         }
     }
 
@@ -277,8 +386,7 @@ bool i2c_start(SerialDriver *sd, uint8_t address, uint8_t op) {
 
     // This is a two-byte command: command + (address | op)
     uint8_t start_data[2] = {'s', ((address << 1) | op)};
-    serial_write_to_port(sd->file_descriptor, start_data, sizeof(start_data));
-    return serial_ack(sd);
+    return serial_submit(sd, start_data, sizeof(start_data));
 }
 
 
@@ -289,8 +397,9 @@ bool i2c_start(SerialDriver *sd, uint8_t address, uint8_t op) {
  */
 bool i2c_stop(SerialDriver *sd) {
 
-    serial_send_command(sd, 'p');
-    return serial_ack(sd);
+    // FROM 1.3.0 -- may be windowed
+    uint8_t stop_data[1] = {'p'};
+    return serial_submit(sd, stop_data, sizeof(stop_data));
 }
 
 
@@ -307,27 +416,8 @@ bool i2c_stop(SerialDriver *sd) {
  */
 size_t i2c_write(SerialDriver *sd, const uint8_t bytes[], size_t byte_count) {
 
-    // Count the bytes sent
-    int count = 0;
-    bool ack = false;
-
-    // Write the data out in blocks of 64 bytes
-    for (size_t i = 0 ; i < byte_count ; i += 64) {
-        // Calculate the data length for the prefix byte
-        size_t length = ((byte_count - i) < 64) ? (byte_count - i) : 64;
-        uint8_t write_cmd[65] = {(uint8_t)(PREFIX_BYTE_WRITE + length - 1)};
-
-        // Write a block of bytes to the send buffer
-        memcpy(write_cmd + 1, bytes + i, length);
-
-        // Write out the block -- use ACK as byte count
-        serial_write_to_port(sd->file_descriptor, write_cmd, 1 + length);
-        ack = serial_ack(sd);
-        if (!ack) break;
-        count += length;
-    }
-
-    return count;
+    // FROM 1.3.0 -- the serial driver picks the best frame type
+    return serial_write(sd, bytes, byte_count);
 }
 
 
@@ -340,21 +430,87 @@ size_t i2c_write(SerialDriver *sd, const uint8_t bytes[], size_t byte_count) {
  */
 void i2c_read(SerialDriver *sd, uint8_t bytes[], size_t byte_count) {
 
-    for (size_t i = 0 ; i < byte_count ; i += 64) {
-        // Calculate data length for prefix byte
-        size_t length = ((byte_count - i) < 64) ? (byte_count - i) : 64;
-        uint8_t read_cmd[1] = {(uint8_t)(PREFIX_BYTE_READ + length - 1)};
+    // FROM 1.3.0 -- the serial driver picks the best frame type
+    serial_read(sd, bytes, byte_count);
+}
 
-        serial_write_to_port(sd->file_descriptor, read_cmd, 1);
-        size_t result = serial_read_from_port(sd->file_descriptor, bytes + i, length);
-        if (result == -1) {
-            print_error("Could not read back from device");
-        } else {
-            for (size_t i = 0 ; i < result ; ++i) {
-                fprintf(stdout, "%02X", bytes[i]);
-            }
 
-            fprintf(stdout, "\n");
-        }
-    }
+#pragma mark - I2C Transaction Program Functions
+
+/**
+ * @brief Add an I2C write to a transaction program. Unless the next op is
+ *        a stop, the bus is held for a repeated start.
+ *        FROM 1.3.0
+ *
+ * @param program:    Pointer to a Program structure.
+ * @param address:    The target device's I2C address.
+ * @param bytes:      The bytes to write.
+ * @param byte_count: The number of bytes to write.
+ *
+ * @returns Whether the op fitted in the program (`true`) or not (`false`).
+ */
+bool i2c_transaction_write(Program *program, uint8_t address, const uint8_t bytes[], size_t byte_count) {
+
+    return serial_program_add(program, PROGRAM_OP_I2C_WRITE, address, byte_count, bytes);
+}
+
+
+/**
+ * @brief Add an I2C read to a transaction program.
+ *        FROM 1.3.0
+ *
+ * @param program:    Pointer to a Program structure.
+ * @param address:    The target device's I2C address.
+ * @param byte_count: The number of bytes to read.
+ *
+ * @returns Whether the op fitted in the program (`true`) or not (`false`).
+ */
+bool i2c_transaction_read(Program *program, uint8_t address, size_t byte_count) {
+
+    return serial_program_add(program, PROGRAM_OP_I2C_READ, address, byte_count, NULL);
+}
+
+
+/**
+ * @brief Add an I2C STOP to a transaction program.
+ *        FROM 1.3.0
+ *
+ * @param program: Pointer to a Program structure.
+ *
+ * @returns Whether the op fitted in the program (`true`) or not (`false`).
+ */
+bool i2c_transaction_stop(Program *program) {
+
+    return serial_program_add(program, PROGRAM_OP_I2C_STOP, 0, 0, NULL);
+}
+
+
+/**
+ * @brief Add a pause to a transaction program, eg. to wait for a conversion.
+ *        FROM 1.3.0
+ *
+ * @param program:  Pointer to a Program structure.
+ * @param delay_us: The pause in microseconds.
+ *
+ * @returns Whether the op fitted in the program (`true`) or not (`false`).
+ */
+bool i2c_transaction_delay(Program *program, uint16_t delay_us) {
+
+    return serial_program_add(program, PROGRAM_OP_DELAY, 0, delay_us, NULL);
+}
+
+
+/**
+ * @brief Run an I2C transaction program in a single round trip.
+ *        FROM 1.3.0
+ *
+ * @param sd:         Pointer to a SerialDriver structure.
+ * @param program:    Pointer to a Program structure.
+ * @param read_bytes: A buffer for the bytes read, in op order.
+ *
+ * @returns Whether every op succeeded (`true`) or not (`false`).
+ */
+bool i2c_transaction(SerialDriver *sd, Program *program, uint8_t read_bytes[]) {
+
+    return serial_program_run(sd, program, read_bytes);
 }
@@ -38,6 +38,15 @@
 #define HOST_INFO_BUFFER_MAX_B          129
 #define CONNECTED_DEVICES_MAX_B         120
 #define SCAN_BUFFER_MAX_B               512
+// FROM 1.3.0
+#define I2C_SCAN_BITMAP_LENGTH_B        16
+#define I2C_SCAN_FLAG_WRITE_PROBE       0x01
+#define I2C_SCAN_FLAG_BOTH_BUSES        0x02
+#define I2C_SCAN_RESULT_BUS_0           0x01
+#define I2C_SCAN_RESULT_BUS_1           0x02
+#define I2C_SCAN_RESULT_STUCK_0         0x10
+#define I2C_SCAN_RESULT_STUCK_1         0x20
+#define I2C_BUS_CMD                     'b'
 
 #define ACK                             0x0F
 #define ERR                             0xF0
@@ -61,10 +70,14 @@ bool            i2c_deinit(SerialDriver *sd);
 bool            i2c_set_speed(SerialDriver *sd, long speed);
 bool            i2c_set_bus(SerialDriver *sd, uint8_t bus_id, uint8_t sda_pin, uint8_t scl_pin);
 bool            i2c_reset(SerialDriver *sd);
+bool            i2c_select_bus(SerialDriver *sd, uint8_t bus_id);
 
 // Information
 void            i2c_get_info(SerialDriver *sd, bool do_print);
 void            i2c_scan(SerialDriver *sd);
+bool            i2c_scan_bitmap(SerialDriver *sd, uint8_t bitmap[]);
+bool            i2c_fast_scan(SerialDriver *sd, uint8_t first, uint8_t last, uint16_t timeout_us, uint8_t flags,
+                              uint8_t bitmaps[2][I2C_SCAN_BITMAP_LENGTH_B], uint8_t *result);
 
 // I2C operations
 bool            i2c_start(SerialDriver *sd, uint8_t address, uint8_t op);
@@ -74,6 +87,13 @@ bool            i2c_stop(SerialDriver *sd);
 size_t          i2c_write(SerialDriver *sd, const uint8_t bytes[], size_t nn);
 void            i2c_read(SerialDriver *sd, uint8_t bytes[], size_t nn);
 
+// Transaction programs -- FROM 1.3.0
+bool            i2c_transaction_write(Program *program, uint8_t address, const uint8_t bytes[], size_t byte_count);
+bool            i2c_transaction_read(Program *program, uint8_t address, size_t byte_count);
+bool            i2c_transaction_stop(Program *program);
+bool            i2c_transaction_delay(Program *program, uint16_t delay_us);
+bool            i2c_transaction(SerialDriver *sd, Program *program, uint8_t read_bytes[]);
+
 
 
 #endif  // I2C_DRIVER_H
@@ -97,8 +97,17 @@ int main(int argc, char* argv[]) {
                 // Set up the display driver
                 HT16K33_init(&board, &i2c_data, HT16K33_0_DEG);
 
+                // FROM 1.3.0
+                // Pipeline display updates if the board supports it
+                serial_window_open(&board, WINDOW_SIZE_DEFAULT);
+
                 // Process the commands one by one
                 int result = process_commands(&board, argc, argv, delta);
+                if (board.window_size > 0 && !serial_window_close(&board)) {
+                    print_error("Board reported an error during the update");
+                    result = EXIT_ERR;
+                }
+
                 serial_flush_and_close_port(&board);
                 return result;
             } else {
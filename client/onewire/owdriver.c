@@ -9,6 +9,71 @@
 #include "owdriver.h"
 
 
+#pragma mark - Static Function Prototypes
+
+static uint32_t one_wire_read_ids(SerialDriver *sd, uint64_t ids[], uint32_t id_count_max);
+
+
+#pragma mark - Globals
+
+// FROM 1.3.0
+// Dallas/Maxim CRC8 (X^8 + X^5 + X^4 + 1) and CRC16 (X^16 + X^15 + X^2 + 1)
+// remainders of each byte value, both bit-reversed for LSB-first data
+static const uint8_t crc8_table[256] = {
+    0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+    0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E, 0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC,
+    0x23, 0x7D, 0x9F, 0xC1, 0x42, 0x1C, 0xFE, 0xA0, 0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
+    0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D, 0x7C, 0x22, 0xC0, 0x9E, 0x1D, 0x43, 0xA1, 0xFF,
+    0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5, 0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07,
+    0xDB, 0x85, 0x67, 0x39, 0xBA, 0xE4, 0x06, 0x58, 0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
+    0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6, 0xA7, 0xF9, 0x1B, 0x45, 0xC6, 0x98, 0x7A, 0x24,
+    0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B, 0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9,
+    0x8C, 0xD2, 0x30, 0x6E, 0xED, 0xB3, 0x51, 0x0F, 0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
+    0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92, 0xD3, 0x8D, 0x6F, 0x31, 0xB2, 0xEC, 0x0E, 0x50,
+    0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C, 0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE,
+    0x32, 0x6C, 0x8E, 0xD0, 0x53, 0x0D, 0xEF, 0xB1, 0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
+    0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49, 0x08, 0x56, 0xB4, 0xEA, 0x69, 0x37, 0xD5, 0x8B,
+    0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4, 0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16,
+    0xE9, 0xB7, 0x55, 0x0B, 0x88, 0xD6, 0x34, 0x6A, 0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
+    0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7, 0xB6, 0xE8, 0x0A, 0x54, 0xD7, 0x89, 0x6B, 0x35
+};
+
+static const uint16_t crc16_table[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+
+
 #pragma mark -  1-Wire Setup Functions
 
 /**
@@ -57,6 +122,33 @@ bool one_wire_configure_bus(SerialDriver *sd, uint8_t data_pin) {
 }
 
 
+/**
+ * @brief Switch the 1-Wire bus between standard and overdrive speed.
+ *        Only overdrive-capable devices follow the switch; switching
+ *        off returns every device to standard speed.
+ *        FROM 1.3.0
+ *
+ * @param sd:        Pointer to a SerialDriver structure.
+ * @param is_on:     Use overdrive speed (`true`) or standard speed (`false`).
+ * @param device_id: The ID of the one device to put into overdrive, as
+ *                   listed by a scan, or 0 for all of them.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`).
+ */
+bool one_wire_set_overdrive(SerialDriver *sd, bool is_on, uint64_t device_id) {
+
+    if (!serial_firmware_at_least(sd, 1, 3)) return false;
+
+    uint8_t speed_data[OW_SPEED_CMD_LENGTH_B] = {OW_SPEED_CMD, OW_SPEED_STANDARD};
+    if (is_on) speed_data[1] = device_id == 0 ? OW_SPEED_OVERDRIVE_SKIP : OW_SPEED_OVERDRIVE_MATCH;
+
+    // The ID is sent family code first
+    for (uint32_t i = 0 ; i < 8 ; ++i) speed_data[2 + i] = (uint8_t)(device_id >> (i << 3));
+    serial_write_to_port(sd->file_descriptor, speed_data, OW_SPEED_CMD_LENGTH_B);
+    return serial_ack(sd);
+}
+
+
 #pragma mark -  1-Wire Information Functions
 
 /**
@@ -67,6 +159,27 @@ bool one_wire_configure_bus(SerialDriver *sd, uint8_t data_pin) {
  */
 void one_wire_get_info(SerialDriver *sd, bool do_print) {
 
+    // FROM 1.3.0 -- use the binary status record if we can
+    StatusRecord status;
+    if (serial_get_status(sd, &status)) {
+        if (do_print) {
+            char pid[2 * BOARD_ID_LENGTH_B + 1] = {0};
+            char model[MODEL_NAME_LENGTH_B + 1] = {0};
+            for (int i = 0 ; i < BOARD_ID_LENGTH_B ; ++i) sprintf(&pid[i * 2], "%02X", status.board_id[i]);
+            memcpy(model, status.model, MODEL_NAME_LENGTH_B);
+
+            print_log(" 1-Wire host device: %s", model);
+            print_log("1-Wire host version: %i.%i.%i (%i)", status.fw_major, status.fw_minor, status.fw_patch, status.build_number);
+            print_log("     1-Wire host ID: %s", pid);
+            print_log("    1-Wire data pin: GP%i", status.pins[0]);
+            print_log("  1-Wire is enabled: %s", (status.flags & STATUS_FLAG_READY) ? "YES" : "NO");
+            print_log("       1-Wire speed: %s", (status.flags & STATUS_FLAG_OVERDRIVE) ? "Overdrive" : "Standard");
+            print_log("     1-Wire devices: %i", status.device_count);
+        }
+
+        return;
+    }
+
     uint8_t read_buffer[HOST_INFO_BUFFER_MAX_B] = {0};
     serial_send_command(sd, '?');
     size_t result = serial_read_from_port(sd->file_descriptor, read_buffer, 0);
@@ -129,35 +242,14 @@ void one_wire_get_info(SerialDriver *sd, bool do_print) {
  */
 void one_wire_scan(SerialDriver *sd) {
 
-    char scan_buffer[SCAN_BUFFER_MAX_B] = {0};
-    uint64_t device_list[63] = {0};
-    uint32_t device_count = 0;
+    uint64_t device_list[OW_DEVICE_COUNT_MAX] = {0};
 
     // Request scan from bus host
     serial_send_command(sd, 'd');
-    size_t result = serial_read_from_port(sd->file_descriptor, (uint8_t*)scan_buffer, 0);
-    if (result == -1) {
-        print_error("Could not read scan data from device");
-        return;
-    }
-
-    // If we receive Z(ero), there are no connected devices
-    if (scan_buffer[0] != 'Z') {
-        // Extract device IDs from a sequence of 16 bytes per ID:
-        // 16 bytes = hex string representation of 64-bit value
-
-#ifdef DEBUG
-        print_log("Buffer: %lu bytes, %lu items", strlen(scan_buffer), strlen(scan_buffer) >> 4);
-        print_log("Buffer: %s", scan_buffer);
-#endif
-
-        for (uint32_t i = 0 ; i < strlen(scan_buffer) ; i += 16) {
-            char value[17] = {0};
-            strncpy(value, scan_buffer + i, 16);
-            device_list[device_count] = strtoull((char *)value, NULL, 16);
-            device_count++;
-        }
 
+    // FROM 1.3.0 -- shared with `one_wire_search()`
+    uint32_t device_count = one_wire_read_ids(sd, device_list, OW_DEVICE_COUNT_MAX);
+    if (device_count > 0) {
         for (int i = 0 ; i < device_count ; i++) {
             uint8_t fid = (device_list[i] & 0xFF);
             uint64_t sid = (device_list[i] & 0xFFFFFFFFFFFF00) >> 8;
@@ -169,6 +261,120 @@ void one_wire_scan(SerialDriver *sd) {
 }
 
 
+/**
+ * @brief Have the board search for devices in an alarm state, or of one
+ *        family, or both. The board stops searching once it has left the
+ *        family's part of the ID tree, so this is quicker than a full scan.
+ *        FROM 1.3.0
+ *
+ * @param sd:           Pointer to a SerialDriver structure.
+ * @param alarm_only:   Only find devices in an alarm state.
+ * @param family:       A family code, eg. 0x28 for the DS18B20, or OW_FAMILY_ANY.
+ * @param ids:          Storage for the device IDs found.
+ * @param id_count_max: The most IDs to store.
+ *
+ * @returns The number of devices found.
+ */
+uint32_t one_wire_search(SerialDriver *sd, bool alarm_only, uint8_t family, uint64_t ids[], uint32_t id_count_max) {
+
+    if (!serial_firmware_at_least(sd, 1, 3)) return 0;
+
+    uint8_t search_data[3] = {OW_SEARCH_CMD, alarm_only ? OW_SEARCH_FLAG_ALARM : 0, family};
+    serial_write_to_port(sd->file_descriptor, search_data, 3);
+    return one_wire_read_ids(sd, ids, id_count_max);
+}
+
+
+/**
+ * @brief Run one step of a search driven by the host: read an ID bit and
+ *        its complement, and write the direction taken. The bus must first be
+ *        reset and OW_CMD_SEARCH_ROM, or 0xEC for an alarm search, written.
+ *        FROM 1.3.0
+ *
+ * @param sd:        Pointer to a SerialDriver structure.
+ * @param direction: The direction to take if the devices' bits differ, 1 or 0.
+ *
+ * @returns The OW_TRIPLET_* bits, or -1 on error.
+ */
+int one_wire_triplet(SerialDriver *sd, uint8_t direction) {
+
+    if (!serial_firmware_at_least(sd, 1, 3)) return -1;
+
+    uint8_t triplet_data[2] = {OW_TRIPLET_CMD, direction};
+    serial_write_to_port(sd->file_descriptor, triplet_data, 2);
+
+    uint8_t result = 0;
+    if (serial_read_from_port(sd->file_descriptor, &result, 1) != 1 || result == ERR) return -1;
+    return result;
+}
+
+
+#pragma mark -  1-Wire DS18B20 Functions
+
+/**
+ * @brief Have the board start a temperature conversion on every DS18B20 at
+ *        once, wait for it to complete, then read every known sensor, all in
+ *        a single round trip. The board CRC-checks each scratchpad.
+ *        FROM 1.3.0
+ *
+ * @param sd:                Pointer to a SerialDriver structure.
+ * @param do_convert:        Start a new conversion (`true`), or read the last one (`false`).
+ * @param readings:          Storage for the sensor readings.
+ * @param reading_count_max: The most readings to store.
+ * @param flags:             Pointer to a byte for the OW_TEMP_FLAG_* reply values,
+ *                           or `NULL`.
+ *
+ * @returns The number of sensors read, or -1 on error.
+ */
+int one_wire_read_temperatures(SerialDriver *sd, bool do_convert, OneWireTemperature readings[], uint32_t reading_count_max, uint8_t *flags) {
+
+    if (!serial_firmware_at_least(sd, 1, 3)) return -1;
+
+    // The data must not be confused with windowed replies
+    serial_window_collect(sd);
+
+    uint8_t temps_data[2] = {OW_TEMPERATURES_CMD, do_convert ? 0 : OW_TEMP_FLAG_NO_CONVERT};
+    serial_write_to_port(sd->file_descriptor, temps_data, 2);
+
+    // Read the count alone first: a lone ERR in its place means
+    // the bus is not ready or no devices are present
+    uint8_t header[2] = {0};
+    size_t result = serial_read_from_port(sd->file_descriptor, header, 1);
+    if (result == -1 || header[0] == ERR) {
+        print_error("Board could not read its DS18B20s");
+        return -1;
+    }
+
+    result = serial_read_from_port(sd->file_descriptor, &header[1], 1);
+    if (result == -1) {
+        print_error("Could not read DS18B20 data header from device");
+        return -1;
+    }
+
+    // Always read every record, even those there is no room for
+    uint32_t reading_count = 0;
+    for (uint32_t i = 0 ; i < header[0] ; ++i) {
+        uint8_t record[OW_TEMP_RECORD_LENGTH_B];
+        result = serial_read_from_port(sd->file_descriptor, record, OW_TEMP_RECORD_LENGTH_B);
+        if (result == -1) {
+            print_error("Could not read DS18B20 data from device");
+            return -1;
+        }
+
+        if (reading_count < reading_count_max) {
+            OneWireTemperature *reading = &readings[reading_count++];
+            reading->rom = 0;
+            for (uint32_t j = 0 ; j < 8 ; ++j) reading->rom |= (uint64_t)record[j] << (j << 3);
+            reading->raw_temperature = (int16_t)(record[8] | (record[9] << 8));
+            reading->status = record[10];
+        }
+    }
+
+    if (flags != NULL) *flags = header[1];
+    return (int)reading_count;
+}
+
+
 #pragma mark -  1-Wire Data Transfer Functions
 
 /**
@@ -180,24 +386,8 @@ void one_wire_scan(SerialDriver *sd) {
  */
 void one_wire_read_bytes(SerialDriver *sd, uint8_t bytes[], size_t byte_count) {
 
-    for (size_t i = 0 ; i < byte_count ; i += 64) {
-        // Calculate data length for prefix byte
-        size_t length = ((byte_count - i) < 64) ? (byte_count - i) : 64;
-        uint8_t read_cmd[1] = {(uint8_t)(PREFIX_BYTE_READ + length - 1)};
-        serial_write_to_port(sd->file_descriptor, read_cmd, 1);
-        size_t result = serial_read_from_port(sd->file_descriptor, bytes, length);
-        if (result == -1) {
-            print_error("Could not read back from device");
-        } else {
-#ifndef SWIFT_BUILD
-            for (size_t i = 0 ; i < result ; ++i) {
-                fprintf(stdout, "%02X", bytes[i]);
-            }
-
-            fprintf(stdout, "\n");
-#endif
-        }
-    }
+    // FROM 1.3.0 -- the serial driver picks the best frame type
+    serial_read(sd, bytes, byte_count);
 }
 
 
@@ -212,27 +402,89 @@ void one_wire_read_bytes(SerialDriver *sd, uint8_t bytes[], size_t byte_count) {
  */
 uint32_t one_wire_write_bytes(SerialDriver *sd, const uint8_t bytes[], size_t byte_count) {
 
-    // Count the bytes sent
-    int count = 0;
-    bool ack = false;
+    // FROM 1.3.0 -- the serial driver picks the best frame type
+    return (uint32_t)serial_write(sd, bytes, byte_count);
+}
+
 
-    // Write the data out in blocks of 64 bytes
-    for (size_t i = 0 ; i < byte_count ; i += 64) {
-        // Calculate the data length for the prefix byte
-        size_t length = ((byte_count - i) < 64) ? (byte_count - i) : 64;
-        uint8_t write_cmd[65] = {(uint8_t)(PREFIX_BYTE_WRITE + length - 1)};
+/**
+ * @brief Read data that ends with a CRC from 1-Wire, and check it, so only
+ *        reads that fail need be repeated.
+ *        FROM 1.3.0
+ *
+ * @param sd:         Pointer to an SerialDriver structure.
+ * @param bytes:      A buffer for the bytes to read.
+ * @param byte_count: The number of bytes to read, including the CRC.
+ * @param crc_type:   OW_CRC_8 for a trailing CRC8 byte, or OW_CRC_16 for
+ *                    a trailing inverted CRC16.
+ *
+ * @returns Whether the data matched its CRC (`true`) or not (`false`).
+ */
+bool one_wire_read_bytes_checked(SerialDriver *sd, uint8_t bytes[], size_t byte_count, uint8_t crc_type) {
+
+    serial_read(sd, bytes, byte_count);
+    return one_wire_check_crc(bytes, byte_count, crc_type);
+}
 
-        // Write a block of bytes to the send buffer
-        memcpy(write_cmd + 1, bytes + i, length);
 
-        // Write out the block -- use ACK as byte count
-        serial_write_to_port(sd->file_descriptor, write_cmd, 1 + length);
-        ack = serial_ack(sd);
-        if (!ack) break;
-        count += length;
+#pragma mark -  1-Wire CRC Functions
+
+/**
+ * @brief Calculate the Dallas/Maxim CRC8 of a block of data, as used for
+ *        ROM IDs and scratchpads. A block followed by its CRC yields 0.
+ *        FROM 1.3.0
+ *
+ * @param data:       The bytes to check.
+ * @param byte_count: The number of bytes.
+ *
+ * @returns The CRC.
+ */
+uint8_t one_wire_crc8(const uint8_t data[], size_t byte_count) {
+
+    uint8_t crc = 0;
+    for (size_t i = 0 ; i < byte_count ; ++i) crc = crc8_table[crc ^ data[i]];
+    return crc;
+}
+
+
+/**
+ * @brief Calculate the Dallas/Maxim CRC16 of a block of data, as used by
+ *        memory devices. Devices send the CRC inverted, LSB first.
+ *        FROM 1.3.0
+ *
+ * @param data:       The bytes to check.
+ * @param byte_count: The number of bytes.
+ * @param crc:        The CRC so far, to continue a calculation, or 0.
+ *
+ * @returns The CRC.
+ */
+uint16_t one_wire_crc16(const uint8_t data[], size_t byte_count, uint16_t crc) {
+
+    for (size_t i = 0 ; i < byte_count ; ++i) crc = (crc >> 8) ^ crc16_table[(crc ^ data[i]) & 0xFF];
+    return crc;
+}
+
+
+/**
+ * @brief Check a block of data that ends with its CRC.
+ *        FROM 1.3.0
+ *
+ * @param data:       The bytes to check, including the CRC.
+ * @param byte_count: The number of bytes, including the CRC.
+ * @param crc_type:   OW_CRC_8 for a trailing CRC8 byte, or OW_CRC_16
+ *                    for a trailing inverted CRC16.
+ *
+ * @returns Whether the CRC matches (`true`) or not (`false`).
+ */
+bool one_wire_check_crc(const uint8_t data[], size_t byte_count, uint8_t crc_type) {
+
+    if (crc_type == OW_CRC_8) {
+        return (byte_count > 1 && one_wire_crc8(data, byte_count) == 0);
     }
 
-    return count;
+    if (byte_count < 3) return false;
+    uint16_t crc = (uint16_t)~one_wire_crc16(data, byte_count - 2, 0);
+    return (crc == (data[byte_count - 2] | (data[byte_count - 1] << 8)));
 }
 
 
@@ -283,3 +535,142 @@ void one_wire_cmd_match_rom(SerialDriver *sd) {
     uint8_t cmd = OW_CMD_MATCH_ROM;
     one_wire_write_bytes(sd, &cmd, 1);
 }
+
+
+#pragma mark -  1-Wire Transaction Program Functions
+
+/**
+ * @brief Add a 1-Wire reset to a transaction program.
+ *        FROM 1.3.0
+ *
+ * @param program: Pointer to a Program structure.
+ *
+ * @returns Whether the op fitted in the program (`true`) or not (`false`).
+ */
+bool one_wire_transaction_reset(Program *program) {
+
+    return serial_program_add(program, PROGRAM_OP_OW_RESET, 0, 0, NULL);
+}
+
+
+/**
+ * @brief Add a 1-Wire write to a transaction program.
+ *        FROM 1.3.0
+ *
+ * @param program:    Pointer to a Program structure.
+ * @param bytes:      The bytes to write.
+ * @param byte_count: The number of bytes to write.
+ *
+ * @returns Whether the op fitted in the program (`true`) or not (`false`).
+ */
+bool one_wire_transaction_write(Program *program, const uint8_t bytes[], size_t byte_count) {
+
+    return serial_program_add(program, PROGRAM_OP_OW_WRITE, 0, byte_count, bytes);
+}
+
+
+/**
+ * @brief Add a 1-Wire read to a transaction program.
+ *        FROM 1.3.0
+ *
+ * @param program:    Pointer to a Program structure.
+ * @param byte_count: The number of bytes to read.
+ *
+ * @returns Whether the op fitted in the program (`true`) or not (`false`).
+ */
+bool one_wire_transaction_read(Program *program, size_t byte_count) {
+
+    return serial_program_add(program, PROGRAM_OP_OW_READ, 0, byte_count, NULL);
+}
+
+
+/**
+ * @brief Add a 1-Wire read of data that ends with a CRC to a transaction
+ *        program. The board checks the CRC: if it fails, the op's status is
+ *        the board's CRC error code, no data is returned for it, and the
+ *        rest of the program is skipped.
+ *        FROM 1.3.0
+ *
+ * @param program:    Pointer to a Program structure.
+ * @param byte_count: The number of bytes to read, including the CRC.
+ * @param crc_type:   OW_CRC_8 or OW_CRC_16.
+ *
+ * @returns Whether the op fitted in the program (`true`) or not (`false`).
+ */
+bool one_wire_transaction_read_checked(Program *program, size_t byte_count, uint8_t crc_type) {
+
+    return serial_program_add(program, crc_type == OW_CRC_8 ? PROGRAM_OP_OW_READ_CRC8 : PROGRAM_OP_OW_READ_CRC16, 0, byte_count, NULL);
+}
+
+
+/**
+ * @brief Run a 1-Wire transaction program in a single round trip.
+ *        FROM 1.3.0
+ *
+ * @param sd:         Pointer to a SerialDriver structure.
+ * @param program:    Pointer to a Program structure.
+ * @param read_bytes: A buffer for the bytes read, in op order.
+ *
+ * @returns Whether every op succeeded (`true`) or not (`false`).
+ */
+bool one_wire_transaction(SerialDriver *sd, Program *program, uint8_t read_bytes[]) {
+
+    return serial_program_run(sd, program, read_bytes);
+}
+
+
+#pragma mark -  1-Wire Static Functions
+
+/**
+ * @brief Read a list of device IDs sent in response to a scan or search.
+ *        FROM 1.3.0
+ *
+ * @param sd:           Pointer to a SerialDriver structure.
+ * @param ids:          Storage for the device IDs.
+ * @param id_count_max: The most IDs to store.
+ *
+ * @returns The number of IDs read.
+ */
+static uint32_t one_wire_read_ids(SerialDriver *sd, uint64_t ids[], uint32_t id_count_max) {
+
+    // Room for a full list of 16-character IDs and the \r\n
+    char scan_buffer[(OW_DEVICE_COUNT_MAX << 4) + 3] = {0};
+    uint32_t device_count = 0;
+
+    size_t result = serial_read_from_port(sd->file_descriptor, (uint8_t*)scan_buffer, 0);
+    if (result == -1) {
+        print_error("Could not read scan data from device");
+        return 0;
+    }
+
+    // If we receive Z(ero), there are no connected devices
+    if (scan_buffer[0] == 'Z') return 0;
+
+    // Extract device IDs from a sequence of 16 bytes per ID:
+    // 16 bytes = hex string representation of 64-bit value
+
+#ifdef DEBUG
+    print_log("Buffer: %lu bytes, %lu items", strlen(scan_buffer), strlen(scan_buffer) >> 4);
+    print_log("Buffer: %s", scan_buffer);
+#endif
+
+    size_t length = strlen(scan_buffer);
+    for (uint32_t i = 0 ; i + 16 <= length && device_count < id_count_max ; i += 16) {
+        char value[17] = {0};
+        strncpy(value, scan_buffer + i, 16);
+        uint64_t id = strtoull((char *)value, NULL, 16);
+
+        // Check the ID's CRC, which is its MSB
+        uint8_t id_bytes[8];
+        for (uint32_t j = 0 ; j < 8 ; ++j) id_bytes[j] = (uint8_t)(id >> (j << 3));
+        if (!one_wire_check_crc(id_bytes, 8, OW_CRC_8)) {
+            print_warning("Device ID %s failed its CRC check", value);
+            continue;
+        }
+
+        ids[device_count] = id;
+        device_count++;
+    }
+
+    return device_count;
+}
@@ -33,6 +33,47 @@
 #define     OW_CMD_SEARCH_ROM               0xF0
 #define     OW_CMD_MATCH_ROM                0x55
 
+// FROM 1.3.0
+#define     OW_SPEED_CMD                    'o'
+#define     OW_SPEED_CMD_LENGTH_B           10
+#define     OW_SPEED_STANDARD               0
+#define     OW_SPEED_OVERDRIVE_SKIP         1
+#define     OW_SPEED_OVERDRIVE_MATCH        2
+
+// FROM 1.3.0
+#define     OW_SEARCH_CMD                   'S'
+#define     OW_TRIPLET_CMD                  'Y'
+#define     OW_SEARCH_FLAG_ALARM            0x01
+#define     OW_FAMILY_ANY                   0x00
+#define     OW_DEVICE_COUNT_MAX             64
+#define     OW_TRIPLET_ID_BIT               0x01
+#define     OW_TRIPLET_CMP_BIT              0x02
+#define     OW_TRIPLET_DIR_BIT              0x04
+
+// FROM 1.3.0
+#define     OW_TEMPERATURES_CMD             'C'
+#define     OW_TEMP_RECORD_LENGTH_B         11
+#define     OW_TEMP_FLAG_NO_CONVERT         0x01    // Request: read the last conversions only
+#define     OW_TEMP_FLAG_CONVERT_TIMEOUT    0x01    // Reply: the conversion never signalled completion
+#define     OW_TEMP_STATUS_OK               0x00
+#define     OW_TEMP_STATUS_NOT_PRESENT      0x01
+#define     OW_TEMP_STATUS_CRC_ERROR        0x02
+
+// FROM 1.3.0
+#define     OW_CRC_8                        8
+#define     OW_CRC_16                       16
+
+
+/*
+ * STRUCTURES
+ */
+// FROM 1.3.0
+typedef struct {
+    uint64_t    rom;                        // The sensor's device ID
+    int16_t     raw_temperature;            // In 1/16ths of a degree Celsius
+    uint8_t     status;                     // OW_TEMP_STATUS_* values
+} OneWireTemperature;
+
 
 /*
  * PROTOTYPES
@@ -41,10 +82,17 @@
 bool        one_wire_init(SerialDriver *sd);
 bool        one_wire_reset(SerialDriver *sd);
 bool        one_wire_configure_bus(SerialDriver *sd, uint8_t data_pin);
+bool        one_wire_set_overdrive(SerialDriver *sd, bool is_on, uint64_t device_id);
 
 // Information
 void        one_wire_get_info(SerialDriver *sd, bool do_print);
 void        one_wire_scan(SerialDriver *sd);
+// FROM 1.3.0
+uint32_t    one_wire_search(SerialDriver *sd, bool alarm_only, uint8_t family, uint64_t ids[], uint32_t id_count_max);
+int         one_wire_triplet(SerialDriver *sd, uint8_t direction);
+
+// DS18B20 sensors -- FROM 1.3.0
+int         one_wire_read_temperatures(SerialDriver *sd, bool do_convert, OneWireTemperature readings[], uint32_t reading_count_max, uint8_t *flags);
 
 // Convenience commands
 void        one_wire_cmd_skip_rom(SerialDriver *sd);
@@ -55,6 +103,19 @@ void        one_wire_cmd_match_rom(SerialDriver *sd);
 // Data transfer
 uint32_t    one_wire_write_bytes(SerialDriver *sd, const uint8_t bytes[], size_t byte_count);
 void        one_wire_read_bytes(SerialDriver *sd, uint8_t bytes[], size_t byte_count);
+bool        one_wire_read_bytes_checked(SerialDriver *sd, uint8_t bytes[], size_t byte_count, uint8_t crc_type);
+
+// CRC checks -- FROM 1.3.0
+uint8_t     one_wire_crc8(const uint8_t data[], size_t byte_count);
+uint16_t    one_wire_crc16(const uint8_t data[], size_t byte_count, uint16_t crc);
+bool        one_wire_check_crc(const uint8_t data[], size_t byte_count, uint8_t crc_type);
+
+// Transaction programs -- FROM 1.3.0
+bool        one_wire_transaction_reset(Program *program);
+bool        one_wire_transaction_write(Program *program, const uint8_t bytes[], size_t byte_count);
+bool        one_wire_transaction_read(Program *program, size_t byte_count);
+bool        one_wire_transaction_read_checked(Program *program, size_t byte_count, uint8_t crc_type);
+bool        one_wire_transaction(SerialDriver *sd, Program *program, uint8_t read_bytes[]);
 
 
 #endif      // _ONE_WIRE_DRIVER_H_
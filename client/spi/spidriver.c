@@ -0,0 +1,210 @@
+/*
+ * macOS/Linux Depot SPI driver
+ *
+ * Version 1.3.0
+ * Copyright © 2023, Tony Smith (@smittytone)
+ * Licence: MIT
+ *
+ */
+#include "spidriver.h"
+
+
+#pragma mark - SPI Setup Functions
+
+/**
+ * @brief Tell the board to initialise SPI.
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`).
+ */
+bool spi_init(SerialDriver *sd) {
+
+    serial_send_command(sd, 'i');
+    return serial_ack(sd);
+}
+
+
+/**
+ * @brief Tell the board to de-initialise SPI and release its pins.
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`).
+ */
+bool spi_deinit(SerialDriver *sd) {
+
+    serial_send_command(sd, 'k');
+    return serial_ack(sd);
+}
+
+
+/**
+ * @brief Tell the board to reset SPI.
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`).
+ */
+bool spi_reset(SerialDriver *sd) {
+
+    serial_send_command(sd, 'x');
+    return serial_ack(sd);
+}
+
+
+/**
+ * @brief Choose the SPI bus, its pins, mode and clock. The bus must not
+ *        be initialised. Firmware will return `ERR` on a mis-setting.
+ *
+ * @param sd:       Pointer to a SerialDriver structure.
+ * @param bus_id:   The SPI bus: 0 or 1.
+ * @param sck_pin:  The clock pin GPIO number.
+ * @param tx_pin:   The data out (MOSI) pin GPIO number.
+ * @param rx_pin:   The data in (MISO) pin GPIO number.
+ * @param cs_pin:   The chip select pin GPIO number. This can be any free pin.
+ * @param mode:     The SPI mode, 0-3.
+ * @param baud_khz: The clock speed in kHz, or 0 for the board's default.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`).
+ */
+bool spi_configure_bus(SerialDriver *sd, uint8_t bus_id, uint8_t sck_pin, uint8_t tx_pin, uint8_t rx_pin,
+                       uint8_t cs_pin, uint8_t mode, uint16_t baud_khz) {
+
+    uint8_t set_bus_data[SPI_CONFIG_LENGTH_B] = {'c', bus_id, sck_pin, tx_pin, rx_pin, cs_pin, mode,
+                                                 (uint8_t)(baud_khz & 0xFF), (uint8_t)(baud_khz >> 8)};
+    serial_write_to_port(sd->file_descriptor, set_bus_data, SPI_CONFIG_LENGTH_B);
+    return serial_ack(sd);
+}
+
+
+#pragma mark - SPI Information Functions
+
+/**
+ * @brief Request SPI information from the board.
+ *
+ * @param sd:       Pointer to a SerialDriver structure.
+ * @param do_print: Should the data be output?
+ */
+void spi_get_info(SerialDriver *sd, bool do_print) {
+
+    StatusRecord status;
+    if (!serial_get_status(sd, &status)) {
+        print_error("Could not read SPI information from device");
+        return;
+    }
+
+    if (do_print) {
+        char pid[2 * BOARD_ID_LENGTH_B + 1] = {0};
+        char model[MODEL_NAME_LENGTH_B + 1] = {0};
+        for (int i = 0 ; i < BOARD_ID_LENGTH_B ; ++i) sprintf(&pid[i * 2], "%02X", status.board_id[i]);
+        memcpy(model, status.model, MODEL_NAME_LENGTH_B);
+
+        print_log("   SPI host device: %s", model);
+        print_log("  SPI host version: %i.%i.%i (%i)", status.fw_major, status.fw_minor, status.fw_patch, status.build_number);
+        print_log("       SPI host ID: %s", pid);
+        print_log("     Using SPI bus: %s", status.bus == 0 ? "spi0" : "spi1");
+        print_log("     SPI bus clock: %ikHz", status.frequency_khz);
+        print_log(" Pins used for SPI: GP%i (SCK), GP%i (TX), GP%i (CS)", status.pins[0], status.pins[1], status.address);
+        print_log("    SPI is enabled: %s", (status.flags & STATUS_FLAG_READY) ? "YES" : "NO");
+        print_log("   SPI CS asserted: %s", (status.flags & STATUS_FLAG_STARTED) ? "YES" : "NO");
+    }
+}
+
+
+#pragma mark - SPI Chip Select Functions
+
+/**
+ * @brief Assert the SPI chip select line. It stays asserted
+ *        across transfers until `spi_deselect()` is called.
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`).
+ */
+bool spi_select(SerialDriver *sd) {
+
+    uint8_t select_data[2] = {'s', 0};
+    serial_write_to_port(sd->file_descriptor, select_data, 2);
+    return serial_ack(sd);
+}
+
+
+/**
+ * @brief Release the SPI chip select line.
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`).
+ */
+bool spi_deselect(SerialDriver *sd) {
+
+    serial_send_command(sd, 'p');
+    return serial_ack(sd);
+}
+
+
+#pragma mark - SPI Data Transfer Functions
+
+/**
+ * @brief Write data to the board for SPI transmission. Bytes
+ *        clocked in at the same time are discarded.
+ *
+ * @param sd:         Pointer to a SerialDriver structure.
+ * @param bytes:      The bytes to write.
+ * @param byte_count: The number of bytes to write.
+ *
+ * @returns The number of bytes written.
+ */
+size_t spi_write_bytes(SerialDriver *sd, const uint8_t bytes[], size_t byte_count) {
+
+    return serial_write(sd, bytes, byte_count);
+}
+
+
+/**
+ * @brief Read data via SPI, clocking out zeros.
+ *
+ * @param sd:         Pointer to a SerialDriver structure.
+ * @param bytes:      A buffer for the bytes to read.
+ * @param byte_count: The number of bytes to read.
+ */
+void spi_read_bytes(SerialDriver *sd, uint8_t bytes[], size_t byte_count) {
+
+    serial_read(sd, bytes, byte_count);
+}
+
+
+/**
+ * @brief Write and read data via SPI at the same time.
+ *
+ * @param sd:         Pointer to a SerialDriver structure.
+ * @param tx_bytes:   The bytes to write.
+ * @param rx_bytes:   A buffer for the bytes read. It may be `tx_bytes`.
+ * @param byte_count: The number of bytes to transfer.
+ *
+ * @returns Whether the transfer succeeded (`true`) or not (`false`).
+ */
+bool spi_transfer(SerialDriver *sd, const uint8_t tx_bytes[], uint8_t rx_bytes[], size_t byte_count) {
+
+    // The data must not be confused with windowed replies
+    serial_window_collect(sd);
+
+    for (size_t i = 0 ; i < byte_count ; i += EXTENDED_FRAME_MAX_B) {
+        size_t length = ((byte_count - i) < EXTENDED_FRAME_MAX_B) ? (byte_count - i) : EXTENDED_FRAME_MAX_B;
+        uint8_t transfer_cmd[EXTENDED_HEADER_LENGTH_B + EXTENDED_FRAME_MAX_B];
+        transfer_cmd[0] = SPI_TRANSFER_CMD;
+        transfer_cmd[1] = (uint8_t)(length & 0xFF);
+        transfer_cmd[2] = (uint8_t)(length >> 8);
+        memcpy(&transfer_cmd[EXTENDED_HEADER_LENGTH_B], tx_bytes + i, length);
+
+        serial_write_to_port(sd->file_descriptor, transfer_cmd, EXTENDED_HEADER_LENGTH_B + length);
+        size_t result = serial_read_from_port(sd->file_descriptor, rx_bytes + i, length);
+        if (result == -1) {
+            print_error("Could not read back from device");
+            return false;
+        }
+    }
+
+    return true;
+}
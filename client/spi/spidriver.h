@@ -0,0 +1,61 @@
+/*
+ * macOS/Linux Depot SPI driver
+ *
+ * Version 1.3.0
+ * Copyright © 2023, Tony Smith (@smittytone)
+ * Licence: MIT
+ *
+ */
+#ifndef _SPI_DRIVER_H_
+#define _SPI_DRIVER_H_
+
+
+/*
+ * INCLUDES
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "serialdriver.h"
+#include "utils.h"
+
+
+/*
+ * CONSTANTS
+ */
+#define SPI_TRANSFER_CMD                'X'
+#define SPI_CONFIG_LENGTH_B             9
+#define SPI_MODE_CPHA                   0x01
+#define SPI_MODE_CPOL                   0x02
+#define SPI_MAX_BAUD_KHZ                62500
+
+
+/*
+ * PROTOTYPES
+ */
+// Setup
+bool        spi_init(SerialDriver *sd);
+bool        spi_deinit(SerialDriver *sd);
+bool        spi_reset(SerialDriver *sd);
+bool        spi_configure_bus(SerialDriver *sd, uint8_t bus_id, uint8_t sck_pin, uint8_t tx_pin, uint8_t rx_pin,
+                              uint8_t cs_pin, uint8_t mode, uint16_t baud_khz);
+
+// Information
+void        spi_get_info(SerialDriver *sd, bool do_print);
+
+// SPI operations
+bool        spi_select(SerialDriver *sd);
+bool        spi_deselect(SerialDriver *sd);
+
+// Data transfer
+size_t      spi_write_bytes(SerialDriver *sd, const uint8_t bytes[], size_t byte_count);
+void        spi_read_bytes(SerialDriver *sd, uint8_t bytes[], size_t byte_count);
+bool        spi_transfer(SerialDriver *sd, const uint8_t tx_bytes[], uint8_t rx_bytes[], size_t byte_count);
+
+
+#endif      // _SPI_DRIVER_H_
@@ -0,0 +1,185 @@
+/*
+ * macOS/Linux Depot UART bridge driver
+ *
+ * Version 1.3.0
+ * Copyright © 2023, Tony Smith (@smittytone)
+ * Licence: MIT
+ *
+ */
+#include "uartdriver.h"
+
+
+#pragma mark - UART Setup Functions
+
+/**
+ * @brief Tell the board to initialise the UART. It starts
+ *        buffering received data immediately.
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`).
+ */
+bool uart_init(SerialDriver *sd) {
+
+    serial_send_command(sd, 'i');
+    return serial_ack(sd);
+}
+
+
+/**
+ * @brief Tell the board to de-initialise the UART and release its pins.
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`).
+ */
+bool uart_deinit(SerialDriver *sd) {
+
+    serial_send_command(sd, 'k');
+    return serial_ack(sd);
+}
+
+
+/**
+ * @brief Tell the board to reset the UART, discarding unsent
+ *        and unread data.
+ *
+ * @param sd: Pointer to a SerialDriver structure.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`).
+ */
+bool uart_reset(SerialDriver *sd) {
+
+    serial_send_command(sd, 'x');
+    return serial_ack(sd);
+}
+
+
+/**
+ * @brief Choose the UART, its pins and its data format. The UART must not
+ *        be initialised. Firmware will return `ERR` on a mis-setting.
+ *
+ * @param sd:        Pointer to a SerialDriver structure.
+ * @param bus_id:    The UART: 0 or 1.
+ * @param tx_pin:    The TX pin GPIO number.
+ * @param rx_pin:    The RX pin GPIO number.
+ * @param baud:      The baud rate, or 0 for the board's default.
+ * @param data_bits: The number of data bits, 5-8.
+ * @param stop_bits: The number of stop bits, 1 or 2.
+ * @param parity:    A UART_PARITY_* value.
+ *
+ * @returns Whether the command was ACK'd (`true`) or not (`false`).
+ */
+bool uart_configure_bus(SerialDriver *sd, uint8_t bus_id, uint8_t tx_pin, uint8_t rx_pin, uint32_t baud,
+                        uint8_t data_bits, uint8_t stop_bits, uint8_t parity) {
+
+    uint8_t set_bus_data[UART_CONFIG_LENGTH_B] = {'c', bus_id, tx_pin, rx_pin,
+                                                  (uint8_t)(baud & 0xFF), (uint8_t)((baud >> 8) & 0xFF),
+                                                  (uint8_t)((baud >> 16) & 0xFF), (uint8_t)(baud >> 24),
+                                                  data_bits, stop_bits, parity};
+    serial_write_to_port(sd->file_descriptor, set_bus_data, UART_CONFIG_LENGTH_B);
+    return serial_ack(sd);
+}
+
+
+#pragma mark - UART Information Functions
+
+/**
+ * @brief Request UART information from the board.
+ *
+ * @param sd:       Pointer to a SerialDriver structure.
+ * @param do_print: Should the data be output?
+ */
+void uart_get_info(SerialDriver *sd, bool do_print) {
+
+    StatusRecord status;
+    if (!serial_get_status(sd, &status)) {
+        print_error("Could not read UART information from device");
+        return;
+    }
+
+    if (do_print) {
+        char pid[2 * BOARD_ID_LENGTH_B + 1] = {0};
+        char model[MODEL_NAME_LENGTH_B + 1] = {0};
+        for (int i = 0 ; i < BOARD_ID_LENGTH_B ; ++i) sprintf(&pid[i * 2], "%02X", status.board_id[i]);
+        memcpy(model, status.model, MODEL_NAME_LENGTH_B);
+
+        print_log("   UART host device: %s", model);
+        print_log("  UART host version: %i.%i.%i (%i)", status.fw_major, status.fw_minor, status.fw_patch, status.build_number);
+        print_log("       UART host ID: %s", pid);
+        print_log("         Using UART: %s", status.bus == 0 ? "uart0" : "uart1");
+        print_log("     UART baud rate: ~%ik", status.frequency_khz);
+        print_log(" Pins used for UART: GP%i (TX), GP%i (RX)", status.pins[0], status.pins[1]);
+        print_log("    UART is enabled: %s", (status.flags & STATUS_FLAG_READY) ? "YES" : "NO");
+    }
+}
+
+
+#pragma mark - UART Data Transfer Functions
+
+/**
+ * @brief Send data out of the board's UART. The board ACKs once
+ *        the data is queued, not when it has been sent.
+ *
+ * @param sd:         Pointer to a SerialDriver structure.
+ * @param bytes:      The bytes to write.
+ * @param byte_count: The number of bytes to write.
+ *
+ * @returns The number of bytes queued.
+ */
+size_t uart_write_bytes(SerialDriver *sd, const uint8_t bytes[], size_t byte_count) {
+
+    return serial_write(sd, bytes, byte_count);
+}
+
+
+/**
+ * @brief Collect whatever the board's UART has received, without
+ *        waiting for more to arrive.
+ *
+ * @param sd:             Pointer to a SerialDriver structure.
+ * @param bytes:          A buffer for the bytes read.
+ * @param byte_count_max: The buffer's size. Only one extended frame's
+ *                        worth is collected per call.
+ * @param flags:          Pointer to a byte for the UART_READ_FLAG_* values,
+ *                        or `NULL`.
+ *
+ * @returns The number of bytes read, which may be 0, or -1 on error.
+ */
+int uart_read_available(SerialDriver *sd, uint8_t bytes[], size_t byte_count_max, uint8_t *flags) {
+
+    if (byte_count_max > EXTENDED_FRAME_MAX_B) byte_count_max = EXTENDED_FRAME_MAX_B;
+    if (byte_count_max == 0) return 0;
+
+    // The data must not be confused with windowed replies
+    serial_window_collect(sd);
+
+    uint8_t read_cmd[EXTENDED_HEADER_LENGTH_B] = {UART_READ_CMD, (uint8_t)(byte_count_max & 0xFF), (uint8_t)(byte_count_max >> 8)};
+    serial_write_to_port(sd->file_descriptor, read_cmd, EXTENDED_HEADER_LENGTH_B);
+
+    // Read the flags byte alone first: a lone ERR in its place means
+    // the board is not in UART mode, or its UART is not initialised
+    UARTReadHeader header;
+    size_t result = serial_read_from_port(sd->file_descriptor, (uint8_t*)&header, 1);
+    if (result == -1 || header.flags == ERR) {
+        print_error("Board could not read its UART");
+        return -1;
+    }
+
+    result = serial_read_from_port(sd->file_descriptor, (uint8_t*)&header + 1, UART_READ_HEADER_LENGTH_B - 1);
+    if (result == -1 || header.length > byte_count_max) {
+        print_error("Could not read UART data header from device");
+        return -1;
+    }
+
+    if (header.length > 0) {
+        result = serial_read_from_port(sd->file_descriptor, bytes, header.length);
+        if (result == -1) {
+            print_error("Could not read UART data from device");
+            return -1;
+        }
+    }
+
+    if (flags != NULL) *flags = header.flags;
+    return header.length;
+}
@@ -0,0 +1,71 @@
+/*
+ * macOS/Linux Depot UART bridge driver
+ *
+ * Version 1.3.0
+ * Copyright © 2023, Tony Smith (@smittytone)
+ * Licence: MIT
+ *
+ */
+#ifndef _UART_DRIVER_H_
+#define _UART_DRIVER_H_
+
+
+/*
+ * INCLUDES
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "serialdriver.h"
+#include "utils.h"
+
+
+/*
+ * CONSTANTS
+ */
+#define UART_READ_CMD                   'U'
+#define UART_CONFIG_LENGTH_B            11
+#define UART_READ_HEADER_LENGTH_B       4
+#define UART_READ_FLAG_OVERFLOW         0x01
+#define UART_READ_FLAG_TX_BUSY          0x02
+#define UART_PARITY_NONE                0
+#define UART_PARITY_EVEN                1
+#define UART_PARITY_ODD                 2
+#define UART_MAX_BAUD                   7812500
+
+
+/*
+ * STRUCTURES
+ */
+// Header of the board's reply to UART_READ_CMD. Little-endian, packed
+typedef struct __attribute__((packed)) {
+    uint8_t         flags;              // UART_READ_FLAG_* values
+    uint8_t         reserved;
+    uint16_t        length;             // The number of bytes that follow
+} UARTReadHeader;
+
+
+/*
+ * PROTOTYPES
+ */
+// Setup
+bool        uart_init(SerialDriver *sd);
+bool        uart_deinit(SerialDriver *sd);
+bool        uart_reset(SerialDriver *sd);
+bool        uart_configure_bus(SerialDriver *sd, uint8_t bus_id, uint8_t tx_pin, uint8_t rx_pin, uint32_t baud,
+                               uint8_t data_bits, uint8_t stop_bits, uint8_t parity);
+
+// Information
+void        uart_get_info(SerialDriver *sd, bool do_print);
+
+// Data transfer
+size_t      uart_write_bytes(SerialDriver *sd, const uint8_t bytes[], size_t byte_count);
+int         uart_read_available(SerialDriver *sd, uint8_t bytes[], size_t byte_count_max, uint8_t *flags);
+
+
+#endif      // _UART_DRIVER_H_
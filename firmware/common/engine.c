@@ -0,0 +1,264 @@
+/*
+ * Depot RP2040 Bus Host Firmware - Core 1 bus engine
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#include "engine.h"
+
+
+/*
+ * Core 0 owns USB and framing; core 1 runs the bus engines. Frames pass
+ * from core 0 to core 1 through one single-producer, single-consumer ring,
+ * and replies come back through another. Each core signals the other with
+ * an event (`__sev()`) when it adds to a ring or frees space in one, and
+ * sleeps (`__wfe()`) while it has nothing to do.
+ *
+ * Command ring records: 16-bit LE frame length, flags, sequence number,
+ * error code, 32-bit LE receive time, then the frame itself.
+ */
+
+
+/*
+ * STATIC PROTOTYPES
+ */
+static void engine_main(void);
+static void engine_put_record(uint8_t* header, const uint8_t* frame, uint32_t length);
+
+
+/*
+ * GLOBALS
+ */
+static uint8_t          command_store[ENGINE_COMMAND_QUEUE_LENGTH_B];
+static uint8_t          reply_store[ENGINE_REPLY_QUEUE_LENGTH_B];
+static Ring             command_queue;
+static Ring             reply_queue;
+static uint8_t          engine_frame[ENGINE_FRAME_MAX_B];
+static uint32_t         core1_stack[ENGINE_CORE1_STACK_SIZE_B / sizeof(uint32_t)];
+static EngineHandler    frame_handler = NULL;
+static EngineTickHandler tick_handler = NULL;
+static volatile bool    flush_requested = false;
+static bool             is_in_tick = false;
+
+// Record flags
+#define RECORD_FLAG_SEQUENCE                    0x01
+#define RECORD_FLAG_REJECT                      0x02
+
+
+/**
+ * @brief Prepare the queues and start core 1.
+ *
+ * @param handler: The function core 1 calls for each frame.
+ * @param on_tick: The function core 1 calls whenever it wakes, or NULL.
+ */
+void engine_init(EngineHandler handler, EngineTickHandler on_tick) {
+
+    frame_handler = handler;
+    tick_handler = on_tick;
+    ring_init(&command_queue, command_store, ENGINE_COMMAND_QUEUE_LENGTH_B);
+    ring_init(&reply_queue, reply_store, ENGINE_REPLY_QUEUE_LENGTH_B);
+    multicore_launch_core1_with_stack(engine_main, core1_stack, sizeof(core1_stack));
+}
+
+
+/**
+ * @brief Queue a frame for core 1. If the queue is full, keep sending
+ *        replies to the host until there's room.
+ *
+ * @param frame:    The frame's bytes.
+ * @param length:   The frame's length in bytes.
+ * @param sequence: The frame's window sequence number, or -1.
+ */
+void engine_submit(const uint8_t* frame, uint32_t length, int sequence) {
+
+    if (length > ENGINE_FRAME_MAX_B) length = ENGINE_FRAME_MAX_B;
+    uint8_t header[ENGINE_RECORD_HEADER_LENGTH_B] = {
+        (uint8_t)(length & 0xFF),
+        (uint8_t)(length >> 8),
+        (uint8_t)(sequence < 0 ? 0 : RECORD_FLAG_SEQUENCE),
+        (uint8_t)(sequence < 0 ? 0 : sequence),
+        0, 0, 0, 0, 0
+    };
+
+    engine_put_record(header, frame, length);
+}
+
+
+/**
+ * @brief Have core 1 report an error in sequence with the frames ahead of it.
+ *
+ * @param sequence:   The rejected frame's window sequence number, or -1.
+ * @param error_code: The error to record.
+ */
+void engine_reject(int sequence, uint8_t error_code) {
+
+    uint8_t header[ENGINE_RECORD_HEADER_LENGTH_B] = {
+        0,
+        0,
+        (uint8_t)((sequence < 0 ? 0 : RECORD_FLAG_SEQUENCE) | RECORD_FLAG_REJECT),
+        (uint8_t)(sequence < 0 ? 0 : sequence),
+        error_code, 0, 0, 0, 0
+    };
+
+    engine_put_record(header, NULL, 0);
+}
+
+
+/**
+ * @brief Send queued replies to the host. Core 0 only.
+ *
+ * @returns Whether any replies were sent (`true`) or not (`false`).
+ */
+bool engine_pump(void) {
+
+    uint8_t packet[TRANSPORT_PACKET_LENGTH_B];
+    bool did_send = false;
+
+    // Take the flush request before draining: core 1 queues its bytes
+    // before it asks for a flush, so any request seen here covers bytes
+    // the loop below will send. A request made after this point is kept
+    // for the next call
+    bool do_flush = flush_requested;
+    if (do_flush) flush_requested = false;
+
+    uint32_t available;
+    while ((available = ring_used(&reply_queue)) > 0) {
+        uint32_t length = available < TRANSPORT_PACKET_LENGTH_B ? available : TRANSPORT_PACKET_LENGTH_B;
+        ring_get(&reply_queue, packet, length);
+        transport_put_bytes(packet, length);
+        did_send = true;
+
+        // Core 1 may be waiting for room
+        __sev();
+    }
+
+    if (do_flush) transport_flush();
+
+    return did_send;
+}
+
+
+/**
+ * @brief Are there replies waiting to go to the host?
+ *
+ * @returns `true` if there are, otherwise `false`.
+ */
+bool engine_has_replies(void) {
+
+    return ring_used(&reply_queue) > 0 || flush_requested;
+}
+
+
+/**
+ * @brief Queue reply bytes for core 0 to send. Core 1 only.
+ *        Blocks while the reply queue is full.
+ *
+ * @param data:   The bytes to send.
+ * @param length: The number of bytes.
+ */
+void engine_put_reply(const uint8_t* data, uint32_t length) {
+
+    while (length > 0) {
+        uint32_t space;
+        while ((space = ring_free(&reply_queue)) == 0) __wfe();
+        uint32_t chunk = length < space ? length : space;
+        ring_put(&reply_queue, data, chunk);
+        data += chunk;
+        length -= chunk;
+        __sev();
+    }
+}
+
+
+/**
+ * @brief Ask core 0 to push queued replies to the host now. Core 1 only.
+ */
+void engine_request_flush(void) {
+
+    flush_requested = true;
+    __sev();
+}
+
+
+/**
+ * @brief Let core 1 run its timed work while a frame waits on hardware,
+ *        then sleep until the next event. Core 1 only.
+ *
+ *        The tick handler isn't re-entered: a job that itself waits on
+ *        hardware just sleeps.
+ */
+void engine_yield(void) {
+
+    if (tick_handler != NULL && !is_in_tick) {
+        is_in_tick = true;
+        tick_handler();
+        is_in_tick = false;
+    }
+
+    __wfe();
+}
+
+
+/**
+ * @brief Core 1's loop: run the tick handler, then take frames from the
+ *        command queue and hand them to the frame handler.
+ */
+static void engine_main(void) {
+
+    uint8_t header[ENGINE_RECORD_HEADER_LENGTH_B];
+
+    while (true) {
+        // Timed work is checked on every wake, so anything that signals
+        // an event (eg. a timer IRQ on core 0) can have core 1 run it
+        if (tick_handler != NULL) {
+            is_in_tick = true;
+            tick_handler();
+            is_in_tick = false;
+        }
+        if (!ring_get(&command_queue, header, ENGINE_RECORD_HEADER_LENGTH_B)) {
+            __wfe();
+            continue;
+        }
+
+        uint32_t length = (uint32_t)header[0] | ((uint32_t)header[1] << 8);
+        ring_get(&command_queue, engine_frame, length);
+
+        // Let core 0 know there's room
+        __sev();
+
+        int sequence = (header[2] & RECORD_FLAG_SEQUENCE) ? header[3] : -1;
+        uint8_t error_code = (header[2] & RECORD_FLAG_REJECT) ? header[4] : 0;
+        uint32_t received_us = (uint32_t)header[5] | ((uint32_t)header[6] << 8) | ((uint32_t)header[7] << 16) | ((uint32_t)header[8] << 24);
+        frame_handler(engine_frame, length, sequence, error_code, received_us, ring_used(&command_queue) > 0);
+    }
+}
+
+
+/**
+ * @brief Stamp a record with the time it was received, and add it to
+ *        the command queue, sending replies to the host while waiting
+ *        for room.
+ *
+ * @param header: The record header.
+ * @param frame:  The frame's bytes, or NULL.
+ * @param length: The frame's length in bytes.
+ */
+static void engine_put_record(uint8_t* header, const uint8_t* frame, uint32_t length) {
+
+    // The low 32 bits are enough to time a frame
+    uint32_t now = (uint32_t)time_us_64();
+    header[5] = (uint8_t)(now & 0xFF);
+    header[6] = (uint8_t)((now >> 8) & 0xFF);
+    header[7] = (uint8_t)((now >> 16) & 0xFF);
+    header[8] = (uint8_t)(now >> 24);
+
+    while (ring_free(&command_queue) < ENGINE_RECORD_HEADER_LENGTH_B + length) {
+        if (!engine_pump()) __wfe();
+    }
+
+    ring_put_record(&command_queue, header, ENGINE_RECORD_HEADER_LENGTH_B, frame, length);
+    __sev();
+}
@@ -0,0 +1,64 @@
+/*
+ * Depot RP2040 Bus Host Firmware - Core 1 bus engine
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#ifndef _ENGINE_HEADER_
+#define _ENGINE_HEADER_
+
+
+/*
+ * INCLUDES
+ */
+#include <stdbool.h>
+#include <stdint.h>
+// Pico SDK Includes
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+// App Includes
+#include "ring.h"
+#include "transport.h"
+
+
+/*
+ * CONSTANTS
+ */
+#define ENGINE_COMMAND_QUEUE_LENGTH_B           16384   // Must be a power of two
+#define ENGINE_REPLY_QUEUE_LENGTH_B             4096    // Must be a power of two
+#define ENGINE_FRAME_MAX_B                      4200    // At least RX_BUFFER_LENGTH_B
+#define ENGINE_CORE1_STACK_SIZE_B               8192
+#define ENGINE_RECORD_HEADER_LENGTH_B           9
+
+
+/*
+ * PROTOTYPES
+ */
+// Called on core 1 for each queued frame: the frame, its length, its
+// window sequence number (or -1), an error code to report instead of
+// running the frame (or 0), the low 32 bits of `time_us_64()` when core 0
+// received it, and whether more frames are waiting
+typedef void (*EngineHandler)(uint8_t* frame, uint32_t length, int sequence, uint8_t error_code, uint32_t received_us, bool more_queued);
+
+// Called on core 1 whenever it wakes, and before each frame, to run
+// timed work such as sampling jobs
+typedef void (*EngineTickHandler)(void);
+
+// Core 0
+void    engine_init(EngineHandler handler, EngineTickHandler on_tick);
+void    engine_submit(const uint8_t* frame, uint32_t length, int sequence);
+void    engine_reject(int sequence, uint8_t error_code);
+bool    engine_pump(void);
+bool    engine_has_replies(void);
+
+// Core 1
+void    engine_put_reply(const uint8_t* data, uint32_t length);
+void    engine_request_flush(void);
+void    engine_yield(void);
+
+
+#endif  // _ENGINE_HEADER_
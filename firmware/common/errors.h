@@ -31,6 +31,9 @@ enum HOST_ERRORS {
     GEN_LED_NOT_ENABLED         = 0x03,
     GEN_CANT_CONFIG_BUS         = 0x04,
     GEN_CANT_GET_BUS_INFO       = 0x05,
+    GEN_INCOMPLETE_FRAME        = 0x06,
+    GEN_BAD_FRAME_LENGTH        = 0x07,
+    GEN_BAD_PROGRAM             = 0x08,
 
     // DO NOT USE VALUE 0x0F
     GEN_DO_NOT_USE_ACK          = 0x0F,
@@ -49,19 +52,32 @@ enum HOST_ERRORS {
     SPI_COULD_NOT_WRITE         = 0x41,
     SPI_COULD_NOT_READ          = 0x42,
     SPI_UNAVAILABLE_ON_BOARD    = 0x43,
+    // = 0x44
+    SPI_COULD_NOT_CONFIGURE     = 0x45,
+    SPI_PINS_ALREADY_IN_USE     = 0x46,
+
+    // UART
+    UART_NOT_STARTED            = 0x60,
+    UART_COULD_NOT_WRITE        = 0x61,
+    // = 0x62
+    // = 0x63
+    // = 0x64
+    UART_COULD_NOT_CONFIGURE    = 0x65,
+    UART_PINS_ALREADY_IN_USE    = 0x66,
 
     // ONE-WIRE
     OW_NOT_READY                = 0x80,
     OW_NO_DEVICES_FOUND         = 0x81,
     OW_COULD_NOT_READ           = 0x82,
-    // = 0x83
+    OW_CRC_ERROR                = 0x83,
     // = 0x84
     OW_COULD_NOT_CONFIGURE      = 0x85,
     OW_PIN_ALREADY_IN_USE       = 0x86,
+    OW_COULD_NOT_SET_SPEED      = 0x87,
 
     GPIO_ILLEGAL_PIN            = 0xA0,
-    // = 0xA1
-    // = 0xA2
+    GPIO_NO_FREE_TRIGGER        = 0xA1,
+    GPIO_BAD_TRIGGER_EDGES      = 0xA2,
     // = 0xA3
     // = 0xA4
     GPIO_CANT_SET_PIN           = 0xA5,
@@ -1,7 +1,7 @@
 /*
  * Depot RP2040 Bus Host Firmware - GPIO functions
  *
- * @version     1.2.2
+ * @version     1.3.0
  * @author      Tony Smith (@smittytone)
  * @copyright   2023
  * @licence     MIT
@@ -10,6 +10,21 @@
 #include "gpio.h"
 
 
+/*
+ * STATIC PROTOTYPES
+ */
+// FROM 1.3.0
+static void gpio_edge_irq(uint gpio, uint32_t events);
+
+
+/*
+ * GLOBALS
+ */
+// FROM 1.3.0
+// The edge IRQ handler has no context, so keep the triggers' owner here
+static GPIO_State* trigger_state = NULL;
+
+
 /**
  * @brief Set a GPIO pin.
  *
@@ -78,6 +93,8 @@ bool set_gpio(GPIO_State* gps, uint8_t* read_value, uint8_t* data) {
  */
 void clear_pin(GPIO_State* gps, uint32_t pin) {
 
+    // FROM 1.3.0
+    disarm_trigger(gps, pin);
     gpio_deinit(pin);
     gps->state_map[pin] = 0x00;
 }
@@ -95,3 +112,141 @@ bool is_pin_in_use_by_gpio(GPIO_State* gps, uint8_t pin) {
 
     return (gps->state_map[pin] != 0x00);
 }
+
+
+/**
+ * @brief Arm an edge trigger on a pin, replacing any the pin already
+ *        has. The pin is claimed as an input. The IRQ is enabled on the
+ *        calling core, so call this on core 1.
+ *        FROM 1.3.0
+ *
+ * @param gps:     The GPIO state record.
+ * @param pin:     The pin to watch.
+ * @param edges:   GPIO_TRIGGER_EDGE_* and GPIO_TRIGGER_PULL_* values.
+ * @param program: The transaction program to run on each edge.
+ * @param length:  The program's length in bytes.
+ *
+ * @returns GEN_NO_ERROR, or the reason the trigger could not be armed.
+ */
+uint8_t arm_trigger(GPIO_State* gps, uint8_t pin, uint8_t edges, uint8_t* program, uint32_t length) {
+
+    if (pin > GPIO_PIN_MAX) return GPIO_ILLEGAL_PIN;
+    if ((edges & (GPIO_TRIGGER_EDGE_RISE | GPIO_TRIGGER_EDGE_FALL)) == 0) return GPIO_BAD_TRIGGER_EDGES;
+    if (length > GPIO_TRIGGER_PROGRAM_MAX_B) return GEN_BAD_PROGRAM;
+
+    // Use the pin's existing trigger, or a free one
+    disarm_trigger(gps, pin);
+    GPIO_Trigger* trigger = NULL;
+    for (uint32_t i = 0 ; i < GPIO_TRIGGER_MAX ; ++i) {
+        if (!gps->triggers[i].is_armed) {
+            trigger = &gps->triggers[i];
+            break;
+        }
+    }
+
+    if (trigger == NULL) return GPIO_NO_FREE_TRIGGER;
+
+    // Register pin usage, as `set_gpio()` does, and make it an input
+    if (gps->state_map[pin] == 0x00) {
+        gpio_init(pin);
+        gps->state_map[pin] |= (1 << GPIO_PIN_DIRN_BIT);
+        gps->state_map[pin] |= (1 << GPIO_PIN_STATE_BIT);
+    }
+
+    gpio_set_dir(pin, GPIO_IN);
+    gpio_set_pulls(pin, (edges & GPIO_TRIGGER_PULL_UP) != 0, (edges & GPIO_TRIGGER_PULL_DOWN) != 0);
+
+    memcpy(trigger->program, program, length);
+    trigger->program_length = length;
+    trigger->pin = pin;
+    trigger->edges = edges;
+    trigger->sequence = 0;
+    trigger->is_due = false;
+    trigger->is_overrun = false;
+    trigger->is_armed = true;
+    trigger_state = gps;
+
+    uint32_t events = ((edges & GPIO_TRIGGER_EDGE_RISE) ? GPIO_IRQ_EDGE_RISE : 0) | ((edges & GPIO_TRIGGER_EDGE_FALL) ? GPIO_IRQ_EDGE_FALL : 0);
+    gpio_set_irq_enabled_with_callback(pin, events, true, gpio_edge_irq);
+
+#ifdef DO_UART_DEBUG
+    debug_log("Pin %i trigger armed: %02X", pin, edges);
+#endif
+
+    return GEN_NO_ERROR;
+}
+
+
+/**
+ * @brief Disarm a pin's edge trigger, if it has one. The pin stays
+ *        claimed until it's cleared.
+ *        FROM 1.3.0
+ *
+ * @param gps: The GPIO state record.
+ * @param pin: The pin, or GPIO_TRIGGER_ALL_PINS to disarm every trigger.
+ */
+void disarm_trigger(GPIO_State* gps, uint8_t pin) {
+
+    for (uint32_t i = 0 ; i < GPIO_TRIGGER_MAX ; ++i) {
+        GPIO_Trigger* trigger = &gps->triggers[i];
+        if (trigger->is_armed && (pin == GPIO_TRIGGER_ALL_PINS || trigger->pin == pin)) {
+            gpio_set_irq_enabled(trigger->pin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, false);
+            trigger->is_armed = false;
+            trigger->is_due = false;
+        }
+    }
+}
+
+
+/**
+ * @brief Check whether a trigger has fired and, if it has, collect
+ *        the edge time and clear it, ready for the next edge.
+ *        FROM 1.3.0
+ *
+ * @param gps:        The GPIO state record.
+ * @param index:      The trigger's index.
+ * @param edge_us:    Set to the time of the edge.
+ * @param is_overrun: Set if edges were missed since the last was taken.
+ *
+ * @returns Whether the trigger fired (`true`) or not (`false`).
+ */
+bool take_trigger(GPIO_State* gps, uint32_t index, uint64_t* edge_us, bool* is_overrun) {
+
+    GPIO_Trigger* trigger = &gps->triggers[index];
+    if (!trigger->is_armed || !trigger->is_due) return false;
+
+    // The IRQ runs on this core, so hold it off while the record is read
+    uint32_t irq_state = save_and_disable_interrupts();
+    *edge_us = trigger->edge_us;
+    *is_overrun = trigger->is_overrun;
+    trigger->is_due = false;
+    trigger->is_overrun = false;
+    restore_interrupts(irq_state);
+    return true;
+}
+
+
+/**
+ * @brief GPIO IRQ callback: note the time of an armed pin's edge, and
+ *        wake core 1 to run the pin's program.
+ *        FROM 1.3.0
+ *
+ * @param gpio:   The pin.
+ * @param events: The edges that occurred.
+ */
+static void gpio_edge_irq(uint gpio, uint32_t events) {
+
+    uint64_t now = time_us_64();
+    if (trigger_state == NULL) return;
+
+    for (uint32_t i = 0 ; i < GPIO_TRIGGER_MAX ; ++i) {
+        GPIO_Trigger* trigger = &trigger_state->triggers[i];
+        if (trigger->is_armed && trigger->pin == gpio) {
+            if (trigger->is_due) trigger->is_overrun = true;
+            trigger->edge_us = now;
+            trigger->is_due = true;
+            __sev();
+            break;
+        }
+    }
+}
@@ -1,7 +1,7 @@
 /*
  * Depot RP2040 Bus Host Firmware - GPIIO functions
  *
- * @version     1.2.2
+ * @version     1.3.0
  * @author      Tony Smith (@smittytone)
  * @copyright   2023
  * @licence     MIT
@@ -20,6 +20,7 @@
 #include <string.h>
 // Pico SDK Includes
 #include "pico/stdlib.h"
+#include "hardware/sync.h"
 // App Includes
 #include "serial.h"
 
@@ -30,12 +31,37 @@
 #define GPIO_PIN_DIRN_BIT                       1
 #define GPIO_PIN_STATE_BIT                      0
 #define GPIO_PIN_MAX                            31
+// FROM 1.3.0
+#define GPIO_TRIGGER_MAX                        4
+#define GPIO_TRIGGER_PROGRAM_MAX_B              256
+#define GPIO_TRIGGER_EDGE_RISE                  0x01
+#define GPIO_TRIGGER_EDGE_FALL                  0x02
+#define GPIO_TRIGGER_PULL_UP                    0x04
+#define GPIO_TRIGGER_PULL_DOWN                  0x08
+#define GPIO_TRIGGER_ALL_PINS                   0xFF
 
 /*
  * STRUCTURES
  */
+// FROM 1.3.0
+// A pin edge that runs a transaction program. The edge IRQ fires
+// on core 1, and only records the time: core 1 runs the program
 typedef struct {
-    uint8_t     state_map[GPIO_PIN_MAX + 1];
+    bool                is_armed;
+    uint8_t             pin;
+    uint8_t             edges;
+    uint16_t            sequence;
+    uint32_t            program_length;
+    uint8_t             program[GPIO_TRIGGER_PROGRAM_MAX_B];
+    volatile bool       is_due;
+    volatile bool       is_overrun;
+    volatile uint64_t   edge_us;
+} GPIO_Trigger;
+
+typedef struct {
+    uint8_t         state_map[GPIO_PIN_MAX + 1];
+    // FROM 1.3.0
+    GPIO_Trigger    triggers[GPIO_TRIGGER_MAX];
 } GPIO_State;
 
 
@@ -45,5 +71,9 @@ typedef struct {
 bool    set_gpio(GPIO_State* gps, uint8_t* read_value, uint8_t* data);
 void    clear_pin(GPIO_State* gps, uint32_t pin);
 bool    is_pin_in_use_by_gpio(GPIO_State* gps, uint8_t pin);
+// FROM 1.3.0
+uint8_t arm_trigger(GPIO_State* gps, uint8_t pin, uint8_t edges, uint8_t* program, uint32_t length);
+void    disarm_trigger(GPIO_State* gps, uint8_t pin);
+bool    take_trigger(GPIO_State* gps, uint32_t index, uint64_t* edge_us, bool* is_overrun);
 
 #endif  // _GPIO_HEADER_
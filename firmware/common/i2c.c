@@ -15,6 +15,15 @@
  */
 static bool check_i2c_pins(uint8_t* data);
 static bool pin_check(uint8_t* pins, uint8_t pin);
+static void scan_i2c_bus(I2C_State* its, uint8_t* bitmap);
+static bool is_i2c_bus_stuck(I2C_Scan_Probe* probe);
+static void start_probe(I2C_Scan_Probe* probe, bool do_write, uint32_t timeout_us);
+static void poll_probe(I2C_Scan_Probe* probe, uint8_t last_address, bool do_write, uint32_t timeout_us);
+static int  transfer_i2c_dma(I2C_State* its, uint8_t address, uint8_t* rx_data, uint32_t byte_count, uint32_t timeout_us);
+static void start_i2c_dma(uint channel, uint dreq, volatile void* write_addr, const volatile void* read_addr,
+                          uint32_t count, bool is_16_bit, bool is_read);
+static void i2c_dma_irq(void);
+static int64_t i2c_dma_timed_out(alarm_id_t id, void* user_data);
 
 
 /*
@@ -25,6 +34,17 @@ static bool pin_check(uint8_t* pins, uint8_t pin);
 extern uint8_t I2C_PIN_PAIRS_BUS_0[];
 extern uint8_t I2C_PIN_PAIRS_BUS_1[];
 
+// FROM 1.3.0
+// Both controllers' state records, for the fast scan
+extern I2C_State i2c_states[2];
+
+// FROM 1.3.0
+// IC_DATA_CMD words for DMA transfers. Only core 1 makes transfers,
+// one at a time, so both controllers share it
+static uint16_t i2c_dma_commands[I2C_DMA_BUFFER_LENGTH];
+// The controllers' IRQ handler has no context, so keep their owners here
+static I2C_State* i2c_dma_owners[2] = {NULL, NULL};
+
 
 /**
  * @brief Initialise the host's I2C bus.
@@ -65,6 +85,14 @@ void deinit_i2c(I2C_State* its) {
     its->is_ready = false;
     its->is_started = false;
 
+    // FROM 1.3.0 -- release any DMA channels
+    if (its->dma_tx_channel >= 0) {
+        dma_channel_unclaim(its->dma_tx_channel);
+        dma_channel_unclaim(its->dma_rx_channel);
+        its->dma_tx_channel = -1;
+        its->dma_rx_channel = -1;
+    }
+
 #ifdef DO_UART_DEBUG
     debug_log("I2C deactivated");
 #endif
@@ -149,31 +177,244 @@ bool configure_i2c(I2C_State* its, uint8_t* data) {
  */
 void send_i2c_scan(I2C_State* its) {
 
-    uint8_t rx_data;
-    int reading;
-    char scan_buffer[1024] = {0};
-    uint32_t device_count = 0;;
+    char device_string[4] = {0};
+    uint32_t device_count = 0;
+    uint8_t bitmap[I2C_SCAN_BITMAP_LENGTH_B];
+    scan_i2c_bus(its, bitmap);
 
     // Generate a list if devices by their addresses.
     // List in the form "13.71.A0."
-    for (uint32_t i = 0 ; i < 0x78 ; ++i) {
-        reading = i2c_read_timeout_us(its->bus, i, &rx_data, 1, false, 1000);
-        if (reading > 0) {
-            sprintf(scan_buffer + (device_count * 3), "%02X.", i);
+    // FROM 1.3.0 -- queue each address as it's found
+    for (uint32_t i = 0 ; i < I2C_SCAN_ADDRESS_MAX ; ++i) {
+        if (bitmap[i >> 3] & (1 << (i & 0x07))) {
+            sprintf(device_string, "%02X.", i);
+            tx_queue((uint8_t*)device_string, 3);
             device_count++;
         }
     }
 
     // Write 'Z' if there are no devices,
-    // or send the device list string
-    if (strlen(scan_buffer) == 0) {
-        sprintf(scan_buffer, "Z\r\n");
+    // then terminate the device list string
+    if (device_count == 0) tx_queue((uint8_t*)"Z", 1);
+    tx_queue((uint8_t*)"\r\n", 2);
+
+    // Send the scan data back
+    tx_flush();
+}
+
+
+/**
+ * @brief Scan the I2C bus and send the result as a presence bitmap:
+ *        bit (address % 8) of byte (address / 8) is set if a device
+ *        responded at that address.
+ *        FROM 1.3.0
+ *
+ * @param its: The I2C state record.
+ */
+void send_i2c_scan_bitmap(I2C_State* its) {
+
+    uint8_t bitmap[I2C_SCAN_BITMAP_LENGTH_B];
+    scan_i2c_bus(its, bitmap);
+    tx(bitmap, I2C_SCAN_BITMAP_LENGTH_B);
+}
+
+
+/**
+ * @brief Scan a range of I2C addresses with a caller-set probe timeout, on
+ *        one or both controllers at once, and send back a presence bitmap
+ *        per controller.
+ *        FROM 1.3.0
+ *
+ *        The probes are driven at register level, so each controller runs
+ *        its own probe state machine and both can be polled together. A
+ *        probe that times out with SDA or SCL held low marks the bus stuck
+ *        and ends its scan early.
+ *
+ *        Reply: result flags, then a bitmap for each bus scanned, i2c0 first.
+ *
+ * @param its:  The I2C state record.
+ * @param data: The frame: 'E', first address, last address,
+ *              16-bit LE probe timeout in us (0 for the default), flags.
+ */
+void send_i2c_fast_scan(I2C_State* its, uint8_t* data) {
+
+    uint8_t first = data[1] & 0x7F;
+    uint8_t last = data[2] & 0x7F;
+    uint32_t timeout_us = (uint32_t)data[3] | ((uint32_t)data[4] << 8);
+    uint8_t flags = data[5];
+    bool do_write = (flags & I2C_SCAN_FLAG_WRITE_PROBE) != 0;
+    if (timeout_us == 0) timeout_us = I2C_SCAN_DEFAULT_TIMEOUT_US;
+    if (last > I2C_SCAN_ADDRESS_MAX - 1) last = I2C_SCAN_ADDRESS_MAX - 1;
+
+    // Set up a probe for the current bus and, if asked and it's
+    // running but not mid-transaction, the other one
+    static uint8_t bitmaps[2][I2C_SCAN_BITMAP_LENGTH_B];
+    I2C_Scan_Probe probes[2];
+    uint32_t probe_count = 0;
+    for (uint32_t i = 0 ; i < 2 ; ++i) {
+        I2C_State* state = (i2c_states[i].bus == its->bus ? its : &i2c_states[i]);
+        memset(bitmaps[i], 0, I2C_SCAN_BITMAP_LENGTH_B);
+        if (!state->is_ready) continue;
+        if (state != its && ((flags & I2C_SCAN_FLAG_BOTH_BUSES) == 0 || state->is_started)) continue;
+
+        I2C_Scan_Probe* probe = &probes[probe_count++];
+        probe->bus = state->bus;
+        probe->bitmap = bitmaps[i];
+        probe->address = first;
+        probe->is_probing = false;
+        probe->is_done = (first > last);
+        probe->is_stuck = false;
+        probe->sda_pin = state->sda_pin;
+        probe->scl_pin = state->scl_pin;
+
+        // Don't start on a bus that's already stuck
+        if (is_i2c_bus_stuck(probe)) {
+            probe->is_stuck = true;
+            probe->is_done = true;
+        }
+    }
+
+    // Run the probes until every bus is done
+    bool is_running = true;
+    while (is_running) {
+        is_running = false;
+        for (uint32_t i = 0 ; i < probe_count ; ++i) {
+            if (probes[i].is_done) continue;
+            poll_probe(&probes[i], last, do_write, timeout_us);
+            if (!probes[i].is_done) is_running = true;
+        }
+    }
+
+    // Send the results
+    uint8_t result = 0;
+    for (uint32_t i = 0 ; i < probe_count ; ++i) {
+        bool is_bus_0 = (probes[i].bus == i2c0);
+        result |= (is_bus_0 ? I2C_SCAN_RESULT_BUS_0 : I2C_SCAN_RESULT_BUS_1);
+        if (probes[i].is_stuck) result |= (is_bus_0 ? I2C_SCAN_RESULT_STUCK_0 : I2C_SCAN_RESULT_STUCK_1);
+    }
+
+    tx_queue(&result, 1);
+    if (result & I2C_SCAN_RESULT_BUS_0) tx_queue(bitmaps[0], I2C_SCAN_BITMAP_LENGTH_B);
+    if (result & I2C_SCAN_RESULT_BUS_1) tx_queue(bitmaps[1], I2C_SCAN_BITMAP_LENGTH_B);
+    tx_flush();
+}
+
+
+/**
+ * @brief Start probing a fast scan's current address.
+ *        FROM 1.3.0
+ *
+ * @param probe:      The probe record.
+ * @param do_write:   Probe with a one-byte write rather than a one-byte read.
+ * @param timeout_us: The probe timeout.
+ */
+static void start_probe(I2C_Scan_Probe* probe, bool do_write, uint32_t timeout_us) {
+
+    i2c_hw_t* hw = i2c_get_hw(probe->bus);
+
+    // The target address can only be changed while the controller is disabled
+    hw->enable = 0;
+    hw->tar = probe->address;
+    hw->enable = I2C_IC_ENABLE_ENABLE_BITS;
+
+    // Clear stale events
+    (void)hw->clr_tx_abrt;
+    (void)hw->clr_stop_det;
+
+    // NOTE The RP2040's controller can't issue a zero-length write,
+    //      so a write probe sends a single 0x00 byte
+    hw->data_cmd = I2C_IC_DATA_CMD_STOP_BITS | (do_write ? 0x00 : I2C_IC_DATA_CMD_CMD_BITS);
+    probe->deadline = make_timeout_time_us(timeout_us);
+    probe->is_probing = true;
+}
+
+
+/**
+ * @brief Advance a fast scan probe: start the next address, or check
+ *        whether the current one has answered, been NAK'd or timed out.
+ *        FROM 1.3.0
+ *
+ * @param probe:        The probe record.
+ * @param last_address: The final address to scan.
+ * @param do_write:     Probe with writes rather than reads.
+ * @param timeout_us:   The per-probe timeout.
+ */
+static void poll_probe(I2C_Scan_Probe* probe, uint8_t last_address, bool do_write, uint32_t timeout_us) {
+
+    i2c_hw_t* hw = i2c_get_hw(probe->bus);
+
+    if (!probe->is_probing) {
+        start_probe(probe, do_write, timeout_us);
+        return;
+    }
+
+    uint32_t events = hw->raw_intr_stat;
+    if (events & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+        // NAK'd: nothing at this address
+        (void)hw->clr_tx_abrt;
+    } else if (events & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS) {
+        // ACK'd: drain the read byte, if any
+        (void)hw->clr_stop_det;
+        while (hw->rxflr > 0) (void)hw->data_cmd;
+        probe->bitmap[probe->address >> 3] |= (1 << (probe->address & 0x07));
+    } else if (time_reached(probe->deadline)) {
+        // No outcome: abandon the transfer, and the scan if the bus is stuck
+        hw->enable = I2C_IC_ENABLE_ENABLE_BITS | I2C_IC_ENABLE_ABORT_BITS;
+        absolute_time_t abort_deadline = make_timeout_time_us(timeout_us);
+        while ((hw->enable & I2C_IC_ENABLE_ABORT_BITS) && !time_reached(abort_deadline)) tight_loop_contents();
+        (void)hw->clr_tx_abrt;
+
+        if (is_i2c_bus_stuck(probe)) {
+            probe->is_stuck = true;
+            probe->is_done = true;
+            probe->is_probing = false;
+            return;
+        }
     } else {
-        sprintf(scan_buffer + (device_count * 3), "\r\n");
+        // Still in progress
+        return;
     }
 
-    // Send the scan data back
-    tx(scan_buffer, strlen(scan_buffer));
+    probe->is_probing = false;
+    if (probe->address >= last_address) {
+        probe->is_done = true;
+    } else {
+        probe->address++;
+    }
+}
+
+
+/**
+ * @brief Is either of a bus' lines being held low?
+ *        FROM 1.3.0
+ *
+ * @param probe: The probe record.
+ *
+ * @returns `true` if the bus is stuck, otherwise `false`.
+ */
+static bool is_i2c_bus_stuck(I2C_Scan_Probe* probe) {
+
+    // The lines are pulled up, so they should be high when the bus is idle
+    if (i2c_get_hw(probe->bus)->status & I2C_IC_STATUS_ACTIVITY_BITS) return false;
+    return !gpio_get(probe->sda_pin) || !gpio_get(probe->scl_pin);
+}
+
+
+/**
+ * @brief Probe every I2C address and record which ones respond.
+ *        FROM 1.3.0
+ *
+ * @param its:    The I2C state record.
+ * @param bitmap: A I2C_SCAN_BITMAP_LENGTH_B-byte buffer for the results.
+ */
+static void scan_i2c_bus(I2C_State* its, uint8_t* bitmap) {
+
+    uint8_t rx_data;
+    memset(bitmap, 0, I2C_SCAN_BITMAP_LENGTH_B);
+    for (uint32_t i = 0 ; i < I2C_SCAN_ADDRESS_MAX ; ++i) {
+        int reading = i2c_read_timeout_us(its->bus, i, &rx_data, 1, false, 1000);
+        if (reading > 0) bitmap[i >> 3] |= (1 << (i & 0x07));
+    }
 }
 
 
@@ -184,21 +425,8 @@ void send_i2c_scan(I2C_State* its) {
  */
 void send_i2c_status(I2C_State* its) {
 
-    // Get the RP2040 unique ID
-    char pid[2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1] = {0};
-    pico_get_unique_board_id_string(pid, 2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1);
-    // eg. DF6050788B3E1A2E
-
-    // Get the firmware version as integers
-    int major, minor, patch;
-    sscanf(FW_VERSION, "%i.%i.%i",
-        &major,
-        &minor,
-        &patch
-    );
-
-    char model[HW_MODEL_NAME_SIZE_MAX + 1] = {0};
-    strncat(model, HW_MODEL, HW_MODEL_NAME_SIZE_MAX);
+    // FROM 1.3.0 -- use the identity cached at boot
+    BoardIdentity* identity = get_board_identity();
 
     // Generate and return the status data string.
     // Data in the form: "1.1.100.110.QTPY-RP2040" or "1.1.100.110.PI-PICO"
@@ -212,12 +440,12 @@ void send_i2c_status(I2C_State* its) {
             its->scl_pin,                           // 2-3 chars
             its->frequency,                         // 2 chars
             its->address,                           // 2-4 chars
-            major,                                  // 2-4 chars
-            minor,                                  // 2-4 chars
-            patch,                                  // 2-4 chars
-            BUILD_NUM,                              // 2-4 chars
-            pid,                                    // 17 chars
-            model);                                 // 2-17 chars
+            identity->fw_major,                     // 2-4 chars
+            identity->fw_minor,                     // 2-4 chars
+            identity->fw_patch,                     // 2-4 chars
+            identity->build_number,                 // 2-4 chars
+            identity->board_id_string,              // 17 chars
+            identity->model);                       // 2-17 chars
                                                     // == 41-68 chars
 
     // Send the data
@@ -288,3 +516,282 @@ bool is_pin_in_use_by_i2c(I2C_State* its, uint8_t pin) {
 
     return ((pin == its->sda_pin || pin == its->scl_pin) && its->is_ready);
 }
+
+
+/**
+ * @brief Update the bus' performance counters with the outcome
+ *        of a transfer.
+ *        FROM 1.3.0
+ *
+ * @param its:     The I2C state record.
+ * @param result:  The SDK transfer function's return value.
+ * @param is_read: Was the transfer a read (`true`) or a write (`false`).
+ */
+void count_i2c_transfer(I2C_State* its, int result, bool is_read) {
+
+    if (result == PICO_ERROR_GENERIC) {
+        its->nak_count++;
+    } else if (result == PICO_ERROR_TIMEOUT) {
+        its->timeout_count++;
+    } else if (is_read) {
+        its->bytes_read_total += result;
+    } else {
+        its->bytes_written_total += result;
+    }
+}
+
+
+/**
+ * @brief Write data to an I2C peripheral. Large transfers that end with a
+ *        STOP are made by DMA; others are left to the SDK.
+ *        FROM 1.3.0
+ *
+ * @param its:        The I2C state record.
+ * @param address:    The peripheral's address.
+ * @param data:       The bytes to write.
+ * @param byte_count: The number of bytes to write.
+ * @param nostop:     Hold the bus after the transfer (`true`) or issue a STOP (`false`).
+ * @param timeout_us: The transfer's time limit.
+ *
+ * @returns The number of bytes written, or an SDK error code, as `i2c_write_timeout_us()`.
+ */
+int write_i2c(I2C_State* its, uint8_t address, const uint8_t* data, uint32_t byte_count, bool nostop, uint32_t timeout_us) {
+
+    if (nostop || byte_count < I2C_DMA_THRESHOLD_B || byte_count > I2C_DMA_BUFFER_LENGTH) {
+        return i2c_write_timeout_us(its->bus, address, data, byte_count, nostop, timeout_us);
+    }
+
+    for (uint32_t i = 0 ; i < byte_count ; ++i) i2c_dma_commands[i] = data[i];
+    return transfer_i2c_dma(its, address, NULL, byte_count, timeout_us);
+}
+
+
+/**
+ * @brief Read data from an I2C peripheral. Large transfers that end with a
+ *        STOP are made by DMA; others are left to the SDK.
+ *        FROM 1.3.0
+ *
+ * @param its:        The I2C state record.
+ * @param address:    The peripheral's address.
+ * @param data:       A buffer for the bytes read.
+ * @param byte_count: The number of bytes to read.
+ * @param nostop:     Hold the bus after the transfer (`true`) or issue a STOP (`false`).
+ * @param timeout_us: The transfer's time limit.
+ *
+ * @returns The number of bytes read, or an SDK error code, as `i2c_read_timeout_us()`.
+ */
+int read_i2c(I2C_State* its, uint8_t address, uint8_t* data, uint32_t byte_count, bool nostop, uint32_t timeout_us) {
+
+    if (nostop || byte_count < I2C_DMA_THRESHOLD_B || byte_count > I2C_DMA_BUFFER_LENGTH) {
+        return i2c_read_timeout_us(its->bus, address, data, byte_count, nostop, timeout_us);
+    }
+
+    for (uint32_t i = 0 ; i < byte_count ; ++i) i2c_dma_commands[i] = I2C_IC_DATA_CMD_CMD_BITS;
+    return transfer_i2c_dma(its, address, data, byte_count, timeout_us);
+}
+
+
+/**
+ * @brief Run a transfer, ending with a STOP, by DMA. One channel feeds the
+ *        commands in `i2c_dma_commands` to the controller's TX FIFO and, for
+ *        reads, another empties its RX FIFO, both paced by the controller's
+ *        DREQs. The controller's IRQ signals the STOP, so core 1 runs its
+ *        timed work, or sleeps, until then rather than polling.
+ *        FROM 1.3.0
+ *
+ * @param its:        The I2C state record.
+ * @param address:    The peripheral's address.
+ * @param rx_data:    A buffer for the bytes read, or NULL for a write.
+ * @param byte_count: The number of bytes to transfer.
+ * @param timeout_us: The transfer's time limit.
+ *
+ * @returns The number of bytes transferred, or an SDK error code.
+ */
+static int transfer_i2c_dma(I2C_State* its, uint8_t address, uint8_t* rx_data, uint32_t byte_count, uint32_t timeout_us) {
+
+    i2c_hw_t* hw = i2c_get_hw(its->bus);
+    uint irq = I2C0_IRQ + i2c_hw_index(its->bus);
+    absolute_time_t deadline = make_timeout_time_us(timeout_us);
+    bool is_read = (rx_data != NULL);
+
+    if (its->dma_tx_channel < 0) {
+        its->dma_tx_channel = dma_claim_unused_channel(true);
+        its->dma_rx_channel = dma_claim_unused_channel(true);
+
+        // Core 1 makes the transfers, so the IRQ is set up on that core
+        i2c_dma_owners[i2c_hw_index(its->bus)] = its;
+        irq_set_exclusive_handler(irq, i2c_dma_irq);
+    }
+
+    // Frame the transfer as the SDK would: follow a held bus with a
+    // RESTART, and end with a STOP
+    if (its->bus->restart_on_next) i2c_dma_commands[0] |= I2C_IC_DATA_CMD_RESTART_BITS;
+    i2c_dma_commands[byte_count - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    its->bus->restart_on_next = false;
+
+    hw->enable = 0;
+    hw->tar = address;
+    hw->enable = I2C_IC_ENABLE_ENABLE_BITS;
+    (void)hw->clr_tx_abrt;
+    (void)hw->clr_stop_det;
+
+    // An abort flushes the TX FIFO, so wait for the STOP, which the
+    // controller always sends, rather than for the channels. The IRQ is
+    // only enabled for the transfer: the SDK's own transfers poll
+    its->dma_is_done = false;
+    its->dma_is_busy = true;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS;
+    irq_set_enabled(irq, true);
+
+    // Start the RX channel first, so it's ready for the first byte
+    if (is_read) start_i2c_dma(its->dma_rx_channel, i2c_get_dreq(its->bus, false), rx_data, &hw->data_cmd, byte_count, false, true);
+    start_i2c_dma(its->dma_tx_channel, i2c_get_dreq(its->bus, true), &hw->data_cmd, i2c_dma_commands, byte_count, true, false);
+
+    // The alarm wakes core 1 if the STOP never comes. Without one, just poll
+    alarm_id_t alarm = add_alarm_in_us(timeout_us, i2c_dma_timed_out, NULL, true);
+    while (!its->dma_is_done && !time_reached(deadline)) {
+        if (alarm > 0) {
+            engine_yield();
+        } else {
+            tight_loop_contents();
+        }
+    }
+
+    if (alarm > 0) cancel_alarm(alarm);
+    irq_set_enabled(irq, false);
+    hw->intr_mask = 0;
+
+    bool is_aborted = (hw->tx_abrt_source != 0);
+    bool is_timed_out = !its->dma_is_done;
+    if (is_read && !is_aborted && !is_timed_out) {
+        // The last byte may still be on its way out of the RX FIFO
+        while (dma_channel_is_busy(its->dma_rx_channel)) {
+            if (time_reached(deadline)) {
+                is_timed_out = true;
+                break;
+            }
+
+            tight_loop_contents();
+        }
+    }
+
+    if (is_aborted || is_timed_out || dma_channel_is_busy(its->dma_tx_channel)) {
+        dma_channel_abort(its->dma_tx_channel);
+        dma_channel_abort(its->dma_rx_channel);
+    }
+
+    if (is_timed_out) {
+        // Have the controller give up the transfer, or reset it if it won't
+        absolute_time_t abort_deadline = make_timeout_time_us(I2C_DMA_ABORT_TIMEOUT_US);
+        hw->enable |= I2C_IC_ENABLE_ABORT_BITS;
+        while (hw->enable & I2C_IC_ENABLE_ABORT_BITS) {
+            if (time_reached(abort_deadline)) {
+                reset_i2c(its);
+                break;
+            }
+
+            tight_loop_contents();
+        }
+    }
+
+    (void)hw->clr_tx_abrt;
+    (void)hw->clr_stop_det;
+    its->dma_is_busy = false;
+
+    if (is_timed_out) return PICO_ERROR_TIMEOUT;
+    if (is_aborted) return PICO_ERROR_GENERIC;
+    return (int)byte_count;
+}
+
+
+/**
+ * @brief The controllers' IRQ handler: mark a DMA transfer done once its
+ *        STOP has gone out, and wake core 1 to finish it.
+ *        FROM 1.3.0
+ */
+static void i2c_dma_irq(void) {
+
+    for (uint32_t i = 0 ; i < 2 ; ++i) {
+        I2C_State* its = i2c_dma_owners[i];
+        if (its == NULL) continue;
+
+        // Mask the interrupt rather than clear it: the transfer's
+        // outcome is read once core 1 wakes
+        i2c_hw_t* hw = i2c_get_hw(its->bus);
+        if (hw->intr_stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+            hw->intr_mask = 0;
+            its->dma_is_done = true;
+            __sev();
+        }
+    }
+}
+
+
+/**
+ * @brief Alarm callback: wake core 1 when a DMA transfer has run out of time.
+ *        FROM 1.3.0
+ *
+ * @param id:        The alarm's ID.
+ * @param user_data: Unused.
+ *
+ * @returns 0, so the alarm isn't repeated.
+ */
+static int64_t i2c_dma_timed_out(alarm_id_t id, void* user_data) {
+
+    __sev();
+    return 0;
+}
+
+
+/**
+ * @brief Configure and start one channel of a DMA I2C transfer.
+ *        FROM 1.3.0
+ *
+ * @param channel:    The DMA channel.
+ * @param dreq:       The controller's TX or RX DREQ.
+ * @param write_addr: The destination.
+ * @param read_addr:  The source.
+ * @param count:      The number of transfers.
+ * @param is_16_bit:  Transfer IC_DATA_CMD words (`true`) or data bytes (`false`).
+ * @param is_read:    Copy from the controller (`true`) or to it (`false`).
+ */
+static void start_i2c_dma(uint channel, uint dreq, volatile void* write_addr, const volatile void* read_addr,
+                          uint32_t count, bool is_16_bit, bool is_read) {
+
+    dma_channel_config config = dma_channel_get_default_config(channel);
+    channel_config_set_transfer_data_size(&config, is_16_bit ? DMA_SIZE_16 : DMA_SIZE_8);
+    channel_config_set_dreq(&config, dreq);
+    channel_config_set_read_increment(&config, !is_read);
+    channel_config_set_write_increment(&config, is_read);
+    dma_channel_configure(channel, &config, write_addr, read_addr, count, true);
+}
+
+
+/**
+ * @brief Zero the bus' performance counters.
+ *        FROM 1.3.0
+ *
+ * @param its: The I2C state record.
+ */
+void clear_i2c_counters(I2C_State* its) {
+
+    its->bytes_written_total = 0;
+    its->bytes_read_total = 0;
+    its->nak_count = 0;
+    its->timeout_count = 0;
+}
+
+
+/**
+ * @brief Is a DMA transfer under way on the bus? Timed work run while
+ *        core 1 waits for one must leave the bus alone.
+ *        FROM 1.3.0
+ *
+ * @param its: The I2C state record.
+ *
+ * @returns `true` if the bus is busy, otherwise `false`.
+ */
+bool is_i2c_busy(I2C_State* its) {
+
+    return its->dma_is_busy;
+}
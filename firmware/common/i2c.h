@@ -22,6 +22,8 @@
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
 // App Includes
 #include "serial.h"
 
@@ -33,6 +35,28 @@
 #define DEFAULT_I2C_BUS                         1
 #endif
 
+// FROM 1.3.0
+#define I2C_SCAN_ADDRESS_MAX                    0x78
+#define I2C_SCAN_BITMAP_LENGTH_B                16
+#define I2C_SCAN_DEFAULT_TIMEOUT_US             1000
+// Fast scan request flags
+#define I2C_SCAN_FLAG_WRITE_PROBE               0x01    // Probe with a write, not a read
+#define I2C_SCAN_FLAG_BOTH_BUSES                0x02    // Also scan the other controller if it's active
+// Fast scan result flags
+#define I2C_SCAN_RESULT_BUS_0                   0x01    // A bitmap for i2c0 follows
+#define I2C_SCAN_RESULT_BUS_1                   0x02    // A bitmap for i2c1 follows
+#define I2C_SCAN_RESULT_STUCK_0                 0x10    // i2c0 scan abandoned: bus stuck
+#define I2C_SCAN_RESULT_STUCK_1                 0x20    // i2c1 scan abandoned: bus stuck
+
+// FROM 1.3.0
+// Transfers of this many bytes or more are made by DMA, paced by the
+// controller's DREQs, rather than byte by byte by the CPU
+#define I2C_DMA_THRESHOLD_B                     32
+#define I2C_DMA_BUFFER_LENGTH                   EXTENDED_FRAME_MAX_B
+// How long to let the controller give up a timed-out transfer before
+// resetting it
+#define I2C_DMA_ABORT_TIMEOUT_US                1000
+
 
 /*
  * STRUCTURES
@@ -48,8 +72,33 @@ typedef struct {
     uint32_t    read_byte_count;
     uint32_t    write_byte_count;
     i2c_inst_t* bus;
+    // FROM 1.3.0 -- performance counters
+    uint32_t    bytes_written_total;
+    uint32_t    bytes_read_total;
+    uint32_t    nak_count;
+    uint32_t    timeout_count;
+    // FROM 1.3.0 -- DMA channels, claimed on first use
+    int         dma_tx_channel;
+    int         dma_rx_channel;
+    // FROM 1.3.0 -- DMA transfer progress, set by the controller's IRQ
+    volatile bool dma_is_busy;
+    volatile bool dma_is_done;
 } I2C_State;
 
+// FROM 1.3.0
+// One controller's progress through a fast scan
+typedef struct {
+    i2c_inst_t*     bus;
+    uint8_t*        bitmap;
+    uint8_t         address;
+    uint8_t         sda_pin;
+    uint8_t         scl_pin;
+    bool            is_probing;
+    bool            is_done;
+    bool            is_stuck;
+    absolute_time_t deadline;
+} I2C_Scan_Probe;
+
 
 /*
  * PROTOTYPES
@@ -60,8 +109,16 @@ void    reset_i2c(I2C_State* itr);
 void    set_i2c_frequency(I2C_State* its, uint32_t frequency_khz);
 bool    configure_i2c(I2C_State* its, uint8_t* data);
 void    send_i2c_scan(I2C_State* itr);
+void    send_i2c_scan_bitmap(I2C_State* its);
+void    send_i2c_fast_scan(I2C_State* its, uint8_t* data);
 void    send_i2c_status(I2C_State* itr);
 bool    is_pin_in_use_by_i2c(I2C_State* its, uint8_t pin);
+// FROM 1.3.0
+void    count_i2c_transfer(I2C_State* its, int result, bool is_read);
+int     write_i2c(I2C_State* its, uint8_t address, const uint8_t* data, uint32_t byte_count, bool nostop, uint32_t timeout_us);
+int     read_i2c(I2C_State* its, uint8_t address, uint8_t* data, uint32_t byte_count, bool nostop, uint32_t timeout_us);
+void    clear_i2c_counters(I2C_State* its);
+bool    is_i2c_busy(I2C_State* its);
 
 
 #endif  // _HEADER_LED_
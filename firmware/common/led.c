@@ -1,7 +1,7 @@
 /*
  * Depot RP2040 Bus Host Firmware - LED control middleware
  *
- * @version     1.2.2
+ * @version     1.3.0
  * @author      Tony Smith (@smittytone)
  * @copyright   2023
  * @licence     MIT
@@ -16,22 +16,58 @@
  *
  * It relies on defines set in the boards' respective CMakeList.txt
  * files.
+ *
+ * FROM 1.3.0
+ * The public functions no longer touch the hardware. They record the
+ * requested state, which a repeating timer on core 0 applies every
+ * `LED_TICK_US`. This keeps PIO and PWM updates, and the heartbeat and
+ * flash timing, out of command processing on core 1.
+ */
+
+
+/*
+ * STATIC PROTOTYPES
  */
+static bool led_tick(repeating_timer_t* timer);
+static void board_led_set_state(bool is_on);
+static void board_led_set_colour(uint32_t colour);
+
+
+/*
+ * GLOBALS
+ */
+// FROM 1.3.0
+// Requested state, written by either core and read by the timer
+static volatile uint32_t led_colour = 0;
+static volatile bool     led_colour_changed = false;
+static volatile bool     led_is_on = false;
+static volatile bool     led_heartbeat_enabled = false;
+static volatile uint32_t led_flash_ticks = 0;
+
+// FROM 1.3.0
+// Engine state, only accessed by the timer callback
+static repeating_timer_t led_timer;
+static uint32_t heartbeat_tick = 0;
+static bool     led_is_lit = false;
+
+
+/**
+ * @brief Start the LED engine. Call this on the core whose
+ *        timer IRQ should drive the LED, ie. core 0.
+ *        FROM 1.3.0
+ */
+void led_engine_init(void) {
+
+    add_repeating_timer_us(-LED_TICK_US, led_tick, NULL, &led_timer);
+}
 
 
 /**
  * @brief Turn the LED on.
  */
 void led_on(void) {
-#ifdef NEO_BUILD
-    ws2812_set_state(true);
-#elif defined LED_BUILD
-    pico_led_on();
-#elif defined TINY_BUILD
-    tiny_led_on();
-#elif defined NANO_BUILD
-    nano_led_on();
-#endif
+
+    led_is_on = true;
 }
 
 
@@ -39,15 +75,8 @@ void led_on(void) {
  * @brief Turn the LED off.
  */
 void led_off(void) {
-#ifdef NEO_BUILD
-    ws2812_set_state(false);
-#elif defined LED_BUILD
-    pico_led_off();
-#elif defined TINY_BUILD
-    tiny_led_off();
-#elif defined NANO_BUILD
-    nano_led_off();
-#endif
+
+    led_is_on = false;
 }
 
 
@@ -57,43 +86,118 @@ void led_off(void) {
  * @param is_on: Turn the LED on (`true`) or off (`false`).
  */
 void led_set_state(bool is_on) {
-#ifdef NEO_BUILD
-    ws2812_set_state(is_on);
-#elif defined LED_BUILD
-    pico_led_set_state(is_on);
-#elif defined TINY_BUILD
-    tiny_led_set_state(is_on);
-#elif defined NANO_BUILD
-    nano_led_set_state(is_on);
-#endif
+
+    led_is_on = is_on;
 }
 
 
 /**
  * @brief Flash the LED for the specified number of times.
+ *        FROM 1.3.0 -- returns immediately: the flashes are
+ *        run by the LED engine.
  *
  * @param count: The number of blinks.
  */
 void led_flash(uint32_t count) {
+
+    led_flash_ticks = count * LED_FLASH_TICKS * 2;
+}
+
+
+/**
+ * @brief Set the LED's colour.
+ *        NOTE No Pico function is relevant here -- so it just returns.
+ *
+ * @param colour: The LED colour as an RGB six-digit RGB hex value.
+ */
+void led_set_colour(uint32_t colour) {
+
+    led_colour = colour;
+    led_colour_changed = true;
+}
+
+
+/**
+ * @brief Enable or disable the periodic heartbeat flash.
+ *        FROM 1.3.0
+ *
+ * @param is_enabled: Show the heartbeat (`true`) or not (`false`).
+ */
+void led_set_heartbeat(bool is_enabled) {
+
+    led_heartbeat_enabled = is_enabled;
+}
+
+
+/**
+ * @brief Repeating timer callback: apply the requested LED state.
+ *        A running flash sequence takes priority over the heartbeat,
+ *        which is overlaid on the steady on/off state.
+ *        FROM 1.3.0
+ *
+ * @param timer: The timer record.
+ *
+ * @returns `true` to keep the timer running.
+ */
+static bool led_tick(repeating_timer_t* timer) {
+
+    // Pick up a new colour, and make sure it's shown
+    bool do_refresh = false;
+    if (led_colour_changed) {
+        led_colour_changed = false;
+        board_led_set_colour(led_colour);
+        do_refresh = true;
+    }
+
+    bool is_lit = led_is_on;
+    uint32_t flash_ticks = led_flash_ticks;
+    if (flash_ticks > 0) {
+        // Each flash is `LED_FLASH_TICKS` on, then the same off
+        flash_ticks--;
+        led_flash_ticks = flash_ticks;
+        is_lit = ((flash_ticks / LED_FLASH_TICKS) & 0x01) == 0x01;
+    } else if (led_heartbeat_enabled && heartbeat_tick < LED_HEARTBEAT_FLASH_TICKS) {
+        is_lit = true;
+    }
+
+    if (++heartbeat_tick >= LED_HEARTBEAT_PERIOD_TICKS) heartbeat_tick = 0;
+
+    // Only write to the hardware on a change
+    if (is_lit != led_is_lit || do_refresh) {
+        board_led_set_state(is_lit);
+        led_is_lit = is_lit;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Set the board's LED on or off.
+ *        FROM 1.3.0 -- only called by the LED engine.
+ *
+ * @param is_on: Turn the LED on (`true`) or off (`false`).
+ */
+static void board_led_set_state(bool is_on) {
 #ifdef NEO_BUILD
-    ws2812_flash(count);
+    ws2812_set_state(is_on);
 #elif defined LED_BUILD
-    pico_led_flash(count);
+    pico_led_set_state(is_on);
 #elif defined TINY_BUILD
-    tiny_led_flash(count);
+    tiny_led_set_state(is_on);
 #elif defined NANO_BUILD
-    nano_led_flash(count);
+    nano_led_set_state(is_on);
 #endif
 }
 
 
 /**
- * @brief Set the LED's colour.
- *        NOTE No Pico function is relevant here -- so it just returns.
+ * @brief Set the board's LED colour.
+ *        FROM 1.3.0 -- only called by the LED engine.
  *
  * @param colour: The LED colour as an RGB six-digit RGB hex value.
  */
-void led_set_colour(uint32_t colour) {
+static void board_led_set_colour(uint32_t colour) {
 #ifdef NEO_BUILD
     ws2812_set_colour(colour);
 #elif defined TINY_BUILD
@@ -1,7 +1,7 @@
 /*
  * Depot RP2040 Bus Host Firmware - LED control middleware
  *
- * @version     1.2.2
+ * @version     1.3.0
  * @author      Tony Smith (@smittytone)
  * @copyright   2023
  * @licence     MIT
@@ -30,6 +30,14 @@
 #include "../nano/nano_led.h"
 #endif
 
+// FROM 1.3.0
+// LED engine timing. The engine's timer runs every `LED_TICK_US`,
+// so all other periods are given in ticks
+#define LED_TICK_US                             10000
+#define LED_FLASH_TICKS                         25
+#define LED_HEARTBEAT_PERIOD_TICKS              200
+#define LED_HEARTBEAT_FLASH_TICKS               5
+
 
 /*
  * STRUCTURES
@@ -49,6 +57,9 @@ void led_on(void);
 void led_set_state(bool is_on);
 void led_flash(uint32_t count);
 void led_set_colour(uint32_t colour);
+// FROM 1.3.0
+void led_engine_init(void);
+void led_set_heartbeat(bool is_enabled);
 
 
 #endif  // _HEADER_LED_
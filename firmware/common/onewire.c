@@ -19,6 +19,73 @@ static void     ow_bit_out(OneWireState* ows, uint8_t bit_value);
 static uint8_t  ow_bit_in(OneWireState* ows);
 static uint32_t ow_search(OneWireState* ows, uint32_t next_node, int64_t* cid);
 static void     ow_discover_devices(OneWireState* ows);
+// FROM 1.3.0
+static void     ow_pio_start(OneWireState* ows);
+static uint32_t ow_touch(OneWireState* ows, uint32_t bits, uint32_t bit_count);
+static void     ow_set_timing(OneWireState* ows, bool is_overdrive);
+static void     ow_send_ids(uint64_t* ids, uint32_t id_count);
+static bool     ow_rom_is_valid(uint64_t rom);
+
+
+/*
+ * GLOBALS
+ */
+// FROM 1.3.0
+// Dallas/Maxim CRC8 (X^8 + X^5 + X^4 + 1) and CRC16 (X^16 + X^15 + X^2 + 1)
+// remainders of each byte value, both bit-reversed for LSB-first data
+static const uint8_t ow_crc8_table[256] = {
+    0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+    0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E, 0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC,
+    0x23, 0x7D, 0x9F, 0xC1, 0x42, 0x1C, 0xFE, 0xA0, 0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
+    0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D, 0x7C, 0x22, 0xC0, 0x9E, 0x1D, 0x43, 0xA1, 0xFF,
+    0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5, 0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07,
+    0xDB, 0x85, 0x67, 0x39, 0xBA, 0xE4, 0x06, 0x58, 0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
+    0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6, 0xA7, 0xF9, 0x1B, 0x45, 0xC6, 0x98, 0x7A, 0x24,
+    0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B, 0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9,
+    0x8C, 0xD2, 0x30, 0x6E, 0xED, 0xB3, 0x51, 0x0F, 0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
+    0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92, 0xD3, 0x8D, 0x6F, 0x31, 0xB2, 0xEC, 0x0E, 0x50,
+    0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C, 0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE,
+    0x32, 0x6C, 0x8E, 0xD0, 0x53, 0x0D, 0xEF, 0xB1, 0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
+    0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49, 0x08, 0x56, 0xB4, 0xEA, 0x69, 0x37, 0xD5, 0x8B,
+    0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4, 0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16,
+    0xE9, 0xB7, 0x55, 0x0B, 0x88, 0xD6, 0x34, 0x6A, 0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
+    0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7, 0xB6, 0xE8, 0x0A, 0x54, 0xD7, 0x89, 0x6B, 0x35
+};
+
+static const uint16_t ow_crc16_table[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
 
 
 /**
@@ -31,6 +98,10 @@ void ow_init(OneWireState* ows) {
     ows->device_count = 0;
     ows->current_device = 0;
 
+    // FROM 1.3.0 -- enumerate at standard speed. The standard-length
+    //               reset also returns any overdrive devices to it
+    ow_set_timing(ows, false);
+
     // Reset the bus and enumerate devices
     if (ow_reset(ows)) ow_discover_devices(ows);
 
@@ -48,30 +119,12 @@ void ow_init(OneWireState* ows) {
  */
 bool ow_reset(OneWireState* ows) {
 
-    // Hold period
-    sleep_us(DELAY_STANDARD_G_US);
-
-    // Drive LO
-    gpio_init(ows->data_pin);
-    gpio_set_dir(ows->data_pin, GPIO_OUT);
-    gpio_put(ows->data_pin, false);
-
-    // Hold period
-    sleep_us(DELAY_STANDARD_H_US);
-
-    // Float HI
-    gpio_set_dir(ows->data_pin, GPIO_IN);
-
-    // Hold period
-    sleep_us(DELAY_STANDARD_I_US);
-
-    // Sample the line for devices
-    bool devices_present = !gpio_get(ows->data_pin);
-
-    // Post-sample period
-    sleep_us(DELAY_STANDARD_J_US);
-
-    return devices_present;
+    // FROM 1.3.0 -- the PIO engine times the reset and presence
+    //               pulses, and returns the presence sample
+    ow_pio_start(ows);
+    pio_sm_put_blocking(OW_PIO, ows->pio_sm, OW_PIO_RESET_WORD);
+    uint32_t sample = pio_sm_get_blocking(OW_PIO, ows->pio_sm) >> 31;
+    return (sample == BIT_VALUE_0);
 }
 
 
@@ -100,9 +153,22 @@ static void ow_discover_devices(OneWireState* ows) {
 
     // This is the pointer to the device in the devices space
     while (next_device > 0) {
-        next_device = ow_search(ows, next_device, &current_id);
-        ows->device_ids[device_count] = current_id;
-        device_count++;
+        // FROM 1.3.0 -- repeat a step whose ID fails its CRC,
+        //               and leave the ID out if it keeps failing
+        uint64_t found_id = current_id;
+        uint32_t next_found = 0;
+        for (uint32_t attempt = 0 ; attempt < OW_SEARCH_ATTEMPTS ; ++attempt) {
+            found_id = current_id;
+            next_found = ow_search(ows, next_device, (int64_t*)&found_id);
+            if (ow_rom_is_valid(found_id)) break;
+        }
+
+        current_id = found_id;
+        next_device = next_found;
+        if (ow_rom_is_valid(found_id) && device_count < OW_DEVICE_COUNT_MAX) {
+            ows->device_ids[device_count] = found_id;
+            device_count++;
+        }
     }
 
     ows->device_count = device_count;
@@ -142,22 +208,8 @@ static void ow_bit_out(OneWireState* ows, uint8_t bit_value) {
         All data and commands are transmitted least significant bit first over the 1-Wire bus.
     */
 
-    // Drive LO
-    gpio_set_dir(ows->data_pin, GPIO_OUT);
-    gpio_put(ows->data_pin, false);
-
-    // Line hold period
-    bit_value &= 0x01;
-    sleep_us(bit_value == BIT_VALUE_1 ? DELAY_STANDARD_A_US : DELAY_STANDARD_C_US);;
-
-    // Float HI
-    gpio_set_dir(ows->data_pin, GPIO_IN);
-
-    // Wait period
-    sleep_us(bit_value == BIT_VALUE_1 ? DELAY_STANDARD_B_US : DELAY_STANDARD_D_US);;
-
-    // Recovery period (min)
-    sleep_us(DELAY_STANDARD_R_US);
+    // FROM 1.3.0 -- run the slot on the PIO engine
+    ow_touch(ows, bit_value & 0x01, 1);
 }
 
 
@@ -169,9 +221,35 @@ static void ow_bit_out(OneWireState* ows, uint8_t bit_value) {
  */
 void ow_write_byte(OneWireState* ows, uint8_t byte_value) {
 
-    for (uint8_t i = 0 ; i < 8 ; ++i, byte_value >>= 1) {
-        ow_bit_out(ows, byte_value & 0x01);
+    // FROM 1.3.0 -- the PIO engine sends all eight bits, LSB first
+    ow_touch(ows, byte_value, 8);
+    ows->bytes_written_total++;
+}
+
+
+/**
+ * @brief Write out a run of bytes, keeping the PIO engine's TX FIFO
+ *        topped up so the slots run back to back.
+ *        FROM 1.3.0
+ *
+ * @param ows:        Pointer to a OneWireState structure.
+ * @param data:       The bytes to send.
+ * @param byte_count: The number of bytes to send.
+ */
+void ow_write_bytes(OneWireState* ows, uint8_t* data, uint32_t byte_count) {
+
+    ow_pio_start(ows);
+    uint32_t sent = 0;
+    for (uint32_t done = 0 ; done < byte_count ; ++done) {
+        while (sent < byte_count && sent - done < OW_PIO_FIFO_DEPTH) {
+            pio_sm_put_blocking(OW_PIO, ows->pio_sm, ((uint32_t)data[sent++] << 8) | 8);
+        }
+
+        // Discard the samples taken during the write slots
+        (void)pio_sm_get_blocking(OW_PIO, ows->pio_sm);
     }
+
+    ows->bytes_written_total += byte_count;
 }
 
 
@@ -184,29 +262,8 @@ void ow_write_byte(OneWireState* ows, uint8_t byte_value) {
  */
 static uint8_t ow_bit_in(OneWireState* ows) {
 
-    // Drive LO
-    gpio_set_dir(ows->data_pin, GPIO_OUT);
-    gpio_put(ows->data_pin, false);
-
-    // Hold period
-    sleep_us(DELAY_STANDARD_A_US);
-
-    // Float HI
-    gpio_set_dir(ows->data_pin, GPIO_IN);
-
-    // Pre-sample period
-    sleep_us(DELAY_STANDARD_E_US);
-
-    // Sample value
-    uint8_t sample = gpio_get(ows->data_pin) ? BIT_VALUE_1 : BIT_VALUE_0;
-
-    // Post-sample period
-    sleep_us(DELAY_STANDARD_F_US);
-
-    // Recovery period (min)
-    sleep_us(DELAY_STANDARD_R_US);
-
-    return sample;
+    // FROM 1.3.0 -- a read slot is a write slot for a 1, sampled by the PIO engine
+    return (uint8_t)ow_touch(ows, BIT_VALUE_1, 1);
 }
 
 
@@ -219,13 +276,36 @@ static uint8_t ow_bit_in(OneWireState* ows) {
  */
 uint8_t ow_read_byte(OneWireState* ows) {
 
-    uint8_t value = 0;
-    for (uint32_t i = 0 ; i < 8 ; ++i) {
-        value >>= 1;
-        if (ow_bit_in(ows) == BIT_VALUE_1) value |= 0x80;
+    // FROM 1.3.0 -- the PIO engine runs eight read slots, LSB first
+    uint8_t value = (uint8_t)ow_touch(ows, 0xFF, 8);
+    ows->bytes_read_total++;
+    return value;
+}
+
+
+/**
+ * @brief Read in a run of bytes, keeping the PIO engine's TX FIFO
+ *        topped up so the slots run back to back.
+ *        FROM 1.3.0
+ *
+ * @param ows:        Pointer to a OneWireState structure.
+ * @param buffer:     Storage for the bytes read.
+ * @param byte_count: The number of bytes to read.
+ */
+void ow_read_bytes(OneWireState* ows, uint8_t* buffer, uint32_t byte_count) {
+
+    ow_pio_start(ows);
+    uint32_t sent = 0;
+    for (uint32_t done = 0 ; done < byte_count ; ++done) {
+        while (sent < byte_count && sent - done < OW_PIO_FIFO_DEPTH) {
+            pio_sm_put_blocking(OW_PIO, ows->pio_sm, (0xFF << 8) | 8);
+            sent++;
+        }
+
+        buffer[done] = (uint8_t)(pio_sm_get_blocking(OW_PIO, ows->pio_sm) >> 24);
     }
 
-    return (value & 0xFF);
+    ows->bytes_read_total += byte_count;
 }
 
 
@@ -298,6 +378,287 @@ static uint32_t ow_search(OneWireState* ows, uint32_t next_node, int64_t* cid) {
 }
 
 
+/**
+ * @brief Run one step of a ROM search: read an ID bit and its complement,
+ *        then write the direction to take. Where the devices disagree,
+ *        `direction` is taken; otherwise the bit they agree on is. Nothing
+ *        is written if both bits read are 1, as no device is responding.
+ *        FROM 1.3.0
+ *
+ * @param ows:       Pointer to a OneWireState structure.
+ * @param direction: The direction to take at a discrepancy, 1 or 0.
+ *
+ * @returns The OW_TRIPLET_* bits of the two bits read and the direction written.
+ */
+uint8_t ow_triplet(OneWireState* ows, uint8_t direction) {
+
+    // Two read slots, then the write slot, which depends on them
+    uint32_t bits = ow_touch(ows, 0x03, 2);
+    uint8_t id_bit = bits & 0x01;
+    uint8_t cmp_bit = (bits >> 1) & 0x01;
+    if (id_bit == BIT_VALUE_1 && cmp_bit == BIT_VALUE_1) return OW_TRIPLET_ID_BIT | OW_TRIPLET_CMP_BIT;
+
+    if (id_bit != cmp_bit) direction = id_bit;
+    direction &= 0x01;
+    ow_touch(ows, direction, 1);
+    return (id_bit ? OW_TRIPLET_ID_BIT : 0) | (cmp_bit ? OW_TRIPLET_CMP_BIT : 0) | (direction ? OW_TRIPLET_DIR_BIT : 0);
+}
+
+
+/**
+ * @brief Find the devices that answer a ROM search, without touching the
+ *        device list made by `ow_init()`. A search for a family starts at
+ *        that family's branch of the tree and stops once it leaves it,
+ *        so other devices are never enumerated.
+ *        FROM 1.3.0
+ *
+ * @param ows:          Pointer to a OneWireState structure.
+ * @param search_cmd:   OW_CMD_SEARCH_ROM, or OW_CMD_ALARM_SEARCH for devices
+ *                      in an alarm state only.
+ * @param family:       A family code, or OW_FAMILY_ANY.
+ * @param ids:          Storage for the IDs found.
+ * @param id_count_max: The most IDs to store.
+ *
+ * @returns The number of IDs found.
+ */
+uint32_t ow_search_devices(OneWireState* ows, uint8_t search_cmd, uint8_t family, uint64_t* ids, uint32_t id_count_max) {
+
+    // Preset the family code and force the first pass down it
+    uint64_t rom = family;
+    uint32_t last_discrepancy = (family == OW_FAMILY_ANY) ? 0 : 64;
+    uint32_t id_count = 0;
+
+    while (id_count < id_count_max) {
+        if (!ow_reset(ows)) break;
+        ow_write_byte(ows, search_cmd);
+
+        // Bits are numbered 1-64, LSB first. Up to the last discrepancy,
+        // follow the previous path; at it, take the 1 branch this time
+        uint32_t last_zero = 0;
+        bool is_lost = false;
+        for (uint32_t bit = 1 ; bit <= 64 ; ++bit) {
+            uint64_t mask = 1ULL << (bit - 1);
+            uint8_t direction = (bit < last_discrepancy) ? ((rom & mask) != 0) : (bit == last_discrepancy);
+            uint8_t result = ow_triplet(ows, direction);
+
+            if ((result & (OW_TRIPLET_ID_BIT | OW_TRIPLET_CMP_BIT)) == (OW_TRIPLET_ID_BIT | OW_TRIPLET_CMP_BIT)) {
+                // No device responded
+                is_lost = true;
+                break;
+            }
+
+            if ((result & (OW_TRIPLET_ID_BIT | OW_TRIPLET_CMP_BIT | OW_TRIPLET_DIR_BIT)) == 0) last_zero = bit;
+            rom = (result & OW_TRIPLET_DIR_BIT) ? (rom | mask) : (rom & ~mask);
+        }
+
+        if (is_lost) break;
+        if (family != OW_FAMILY_ANY && (rom & 0xFF) != family) break;
+        last_discrepancy = last_zero;
+
+        // Carry on past an ID that fails its CRC, but don't keep it
+        if (!ow_rom_is_valid(rom)) {
+            if (last_discrepancy == 0) break;
+            continue;
+        }
+
+#ifdef DO_UART_DEBUG
+        debug_log("Device found: %016llX", rom);
+#endif
+
+        ids[id_count++] = rom;
+        if (last_discrepancy == 0) break;
+    }
+
+    return id_count;
+}
+
+
+/**
+ * @brief Send the IDs of the devices found by a filtered search,
+ *        in the form used by `ow_send_scan()`.
+ *        FROM 1.3.0
+ *
+ * @param ows:    Pointer to a OneWireState structure.
+ * @param flags:  OW_SEARCH_FLAG_* values.
+ * @param family: A family code, or OW_FAMILY_ANY.
+ */
+void ow_send_search(OneWireState* ows, uint8_t flags, uint8_t family) {
+
+    uint64_t ids[OW_DEVICE_COUNT_MAX];
+
+    // Bus not yet primed? Do so now
+    if (!ows->is_ready) ow_init(ows);
+
+    uint8_t search_cmd = (flags & OW_SEARCH_FLAG_ALARM) ? OW_CMD_ALARM_SEARCH : OW_CMD_SEARCH_ROM;
+    uint32_t id_count = ows->is_ready ? ow_search_devices(ows, search_cmd, family, ids, OW_DEVICE_COUNT_MAX) : 0;
+    ow_send_ids(ids, id_count);
+}
+
+
+/**
+ * @brief Have every DS18B20 convert at once, wait until they are done,
+ *        then read and check each known sensor's scratchpad, and send
+ *        the results as OW_Temperature_Record structures.
+ *        FROM 1.3.0
+ *
+ * @param ows:   Pointer to a OneWireState structure.
+ * @param flags: OW_TEMP_FLAG_* request values.
+ *
+ * @returns `true` if the results were sent, or `false` if no device is present.
+ */
+bool ow_send_temperatures(OneWireState* ows, uint8_t flags) {
+
+    uint8_t reply_flags = 0;
+    if (!ow_reset(ows)) return false;
+
+    if (flags & OW_TEMP_FLAG_NO_CONVERT) {
+        ow_write_byte(ows, OW_CMD_SKIP_ROM);
+    } else {
+        uint8_t convert[2] = {OW_CMD_SKIP_ROM, OW_CMD_CONVERT_T};
+        ow_write_bytes(ows, convert, 2);
+
+        // Externally powered sensors hold read slots at 0 until every
+        // conversion is complete, so there's no need to wait the full 750ms
+        absolute_time_t deadline = make_timeout_time_ms(OW_CONVERT_TIMEOUT_MS);
+        while (ow_bit_in(ows) == BIT_VALUE_0) {
+            if (time_reached(deadline)) {
+                reply_flags |= OW_TEMP_FLAG_CONVERT_TIMEOUT;
+                break;
+            }
+        }
+    }
+
+    // Count the sensors first: the count leads the reply
+    uint8_t sensor_count = 0;
+    for (uint32_t i = 0 ; i < ows->device_count ; ++i) {
+        uint8_t family = ows->device_ids[i] & 0xFF;
+        if (family == OW_FAMILY_DS18B20 || family == OW_FAMILY_DS1822 || family == OW_FAMILY_DS1825) sensor_count++;
+    }
+
+    uint8_t header[2] = {sensor_count, reply_flags};
+    tx_queue(header, 2);
+
+    for (uint32_t i = 0 ; i < ows->device_count ; ++i) {
+        uint64_t rom = ows->device_ids[i];
+        uint8_t family = rom & 0xFF;
+        if (family != OW_FAMILY_DS18B20 && family != OW_FAMILY_DS1822 && family != OW_FAMILY_DS1825) continue;
+
+        // Address the sensor, then ask for its scratchpad
+        uint8_t read_cmd[OW_ROM_LENGTH_B + 2];
+        read_cmd[0] = OW_CMD_MATCH_ROM;
+        for (uint32_t j = 0 ; j < OW_ROM_LENGTH_B ; ++j) read_cmd[j + 1] = (uint8_t)(rom >> (j << 3));
+        read_cmd[OW_ROM_LENGTH_B + 1] = OW_CMD_READ_SCRATCHPAD;
+
+        uint8_t scratchpad[OW_SCRATCHPAD_LENGTH_B];
+        OW_Temperature_Record record;
+        record.rom = rom;
+        record.raw_temperature = 0;
+
+        if (ow_reset(ows)) {
+            ow_write_bytes(ows, read_cmd, OW_ROM_LENGTH_B + 2);
+            ow_read_bytes(ows, scratchpad, OW_SCRATCHPAD_LENGTH_B);
+
+            // An absent sensor leaves the line high throughout
+            uint8_t all_ones = 0xFF;
+            for (uint32_t j = 0 ; j < OW_SCRATCHPAD_LENGTH_B ; ++j) all_ones &= scratchpad[j];
+
+            if (all_ones == 0xFF) {
+                record.status = OW_TEMP_STATUS_NOT_PRESENT;
+            } else if (!ow_check_crc(scratchpad, OW_SCRATCHPAD_LENGTH_B, OW_CRC_8)) {
+                record.status = OW_TEMP_STATUS_CRC_ERROR;
+            } else {
+                record.raw_temperature = (int16_t)(scratchpad[0] | (scratchpad[1] << 8));
+                record.status = OW_TEMP_STATUS_OK;
+            }
+        } else {
+            record.status = OW_TEMP_STATUS_NOT_PRESENT;
+        }
+
+        tx_queue((uint8_t*)&record, sizeof(record));
+    }
+
+    tx_flush();
+    return true;
+}
+
+
+/**
+ * @brief Calculate the Dallas/Maxim CRC8 of a block of data, as used for
+ *        ROM IDs and scratchpads. A block followed by its CRC yields 0.
+ *        FROM 1.3.0
+ *
+ * @param data:       The bytes to check.
+ * @param byte_count: The number of bytes.
+ *
+ * @returns The CRC.
+ */
+uint8_t ow_crc8(uint8_t* data, uint32_t byte_count) {
+
+    // FROM 1.3.0 -- one table lookup per byte
+    uint8_t crc = 0;
+    for (uint32_t i = 0 ; i < byte_count ; ++i) crc = ow_crc8_table[crc ^ data[i]];
+    return crc;
+}
+
+
+/**
+ * @brief Calculate the Dallas/Maxim CRC16 of a block of data, as used by
+ *        memory devices. Devices send the CRC inverted, LSB first.
+ *        FROM 1.3.0
+ *
+ * @param data:       The bytes to check.
+ * @param byte_count: The number of bytes.
+ * @param crc:        The CRC so far, to continue a calculation, or 0.
+ *
+ * @returns The CRC.
+ */
+uint16_t ow_crc16(uint8_t* data, uint32_t byte_count, uint16_t crc) {
+
+    for (uint32_t i = 0 ; i < byte_count ; ++i) crc = (crc >> 8) ^ ow_crc16_table[(crc ^ data[i]) & 0xFF];
+    return crc;
+}
+
+
+/**
+ * @brief Check a block of data that ends with its CRC.
+ *        FROM 1.3.0
+ *
+ * @param data:       The bytes to check, including the CRC.
+ * @param byte_count: The number of bytes, including the CRC.
+ * @param crc_type:   OW_CRC_8 for a trailing CRC8 byte, or OW_CRC_16
+ *                    for a trailing inverted CRC16.
+ *
+ * @returns `true` if the CRC matches, otherwise `false`.
+ */
+bool ow_check_crc(uint8_t* data, uint32_t byte_count, uint8_t crc_type) {
+
+    if (crc_type == OW_CRC_8) {
+        return (byte_count > 1 && ow_crc8(data, byte_count) == 0);
+    }
+
+    if (byte_count < 3) return false;
+    uint16_t crc = (uint16_t)~ow_crc16(data, byte_count - 2, 0);
+    return (crc == (data[byte_count - 2] | (data[byte_count - 1] << 8)));
+}
+
+
+/**
+ * @brief Check a device ID. An all-zero ID passes its CRC, but means the
+ *        line was held low.
+ *        FROM 1.3.0
+ *
+ * @param rom: The device ID, family code in the LSB.
+ *
+ * @returns `true` if the ID is good, otherwise `false`.
+ */
+static bool ow_rom_is_valid(uint64_t rom) {
+
+    uint8_t bytes[OW_ROM_LENGTH_B];
+    for (uint32_t i = 0 ; i < OW_ROM_LENGTH_B ; ++i) bytes[i] = (uint8_t)(rom >> (i << 3));
+    return (rom != 0 && ow_crc8(bytes, OW_ROM_LENGTH_B) == 0);
+}
+
+
 /**
  * @brief Send device information.
  *
@@ -305,22 +666,8 @@ static uint32_t ow_search(OneWireState* ows, uint32_t next_node, int64_t* cid) {
  */
 void ow_send_state(OneWireState* ows) {
 
-    // Get the RP2040 unique ID
-    char pid[2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1] = {0};
-    pico_get_unique_board_id_string(pid, 2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1);
-    // eg. DF6050788B3E1A2E
-
-    // Get the firmware version as integers
-    int major, minor, patch;
-    sscanf(FW_VERSION, "%i.%i.%i",
-        &major,
-        &minor,
-        &patch
-    );
-
-    char model[HW_MODEL_NAME_SIZE_MAX + 1] = {0};
-    //strncpy(model, model, HW_MODEL_NAME_SIZE_MAX);
-    strncat(model, HW_MODEL, HW_MODEL_NAME_SIZE_MAX);
+    // FROM 1.3.0 -- use the identity cached at boot
+    BoardIdentity* identity = get_board_identity();
 
     // Generate and return the status data string.
     // Data in the form: "1.1.100.110.QTPY-RP2040" or "1.1.100.110.PI-PICO"
@@ -329,12 +676,12 @@ void ow_send_state(OneWireState* ows) {
             (ows->is_ready   ? "1" : "0"),          // 2 chars
             ows->data_pin,                          // 2-3 chars
             ows->device_count,                      // 2-3 chars
-            major,                                  // 2-4 chars
-            minor,                                  // 2-4 chars
-            patch,                                  // 2-4 chars
-            BUILD_NUM,                              // 2-4 chars
-            pid,                                    // 17 chars
-            model);                                 // 2-17 chars
+            identity->fw_major,                     // 2-4 chars
+            identity->fw_minor,                     // 2-4 chars
+            identity->fw_patch,                     // 2-4 chars
+            identity->build_number,                 // 2-4 chars
+            identity->board_id_string,              // 17 chars
+            identity->model);                       // 2-17 chars
                                                     // == 41-68 chars
 
     // Send the data
@@ -349,27 +696,42 @@ void ow_send_state(OneWireState* ows) {
  */
 void ow_send_scan(OneWireState* ows) {
 
-    char scan_buffer[1025] = {0};
-
     // Bus not yet primed? Do so now
     if (!ows->is_ready) ow_init(ows);
 
+    // FROM 1.3.0 -- shared with `ow_send_search()`
+    ow_send_ids(ows->device_ids, ows->device_count);
+}
+
+
+/**
+ * @brief Send a list of device IDs.
+ *        FROM 1.3.0
+ *
+ * @param ids:      The device IDs.
+ * @param id_count: The number of IDs.
+ */
+static void ow_send_ids(uint64_t* ids, uint32_t id_count) {
+
+    char id_string[17] = {0};
+
     // Write 'Z' if there are no devices,
     // or send the device list string
-    if (ows->device_count == 0) {
-        sprintf(scan_buffer, "Z\r\n");
+    if (id_count == 0) {
+        tx_queue((uint8_t*)"Z", 1);
     } else {
         // The string comprises 16 bytes per device: eight hex pairs
         // for the device’s eight bytes of ID.
-        for (uint32_t i = 0 ; i < ows->device_count ; ++i) {
-            sprintf(scan_buffer + (i << 4), "%016llX", ows->device_ids[i]);
+        // FROM 1.3.0 -- queue each ID in turn
+        for (uint32_t i = 0 ; i < id_count ; ++i) {
+            sprintf(id_string, "%016llX", ids[i]);
+            tx_queue((uint8_t*)id_string, 16);
         }
-
-        sprintf(scan_buffer + (ows->device_count << 4), "\r\n");
     }
 
     // Send the scan data back
-    tx(scan_buffer, strlen(scan_buffer));
+    tx_queue((uint8_t*)"\r\n", 2);
+    tx_flush();
 }
 
 
@@ -385,3 +747,110 @@ bool is_pin_in_use_by_ow(OneWireState* ows, uint8_t pin) {
 
     return (pin == ows->data_pin && ows->is_ready);
 }
+
+
+/**
+ * @brief Load the PIO engine and set it up for the data pin, unless
+ *        it is already running on it.
+ *        FROM 1.3.0
+ *
+ * @param ows: Pointer to a OneWireState structure.
+ */
+static void ow_pio_start(OneWireState* ows) {
+
+    if (ows->pio_sm >= 0 && ows->pio_pin == ows->data_pin) return;
+
+    if (ows->pio_sm < 0) {
+        ows->pio_offset = pio_add_program(OW_PIO, &onewire_program);
+        ows->pio_sm = pio_claim_unused_sm(OW_PIO, true);
+    } else {
+        // Moving pins: stop driving the old one
+        pio_sm_set_enabled(OW_PIO, ows->pio_sm, false);
+        gpio_deinit(ows->pio_pin);
+    }
+
+    onewire_program_init(OW_PIO, ows->pio_sm, ows->pio_offset, ows->data_pin,
+                         ows->is_overdrive ? OW_PIO_OVERDRIVE_CYCLE_HZ : OW_PIO_CYCLE_HZ);
+    ows->pio_pin = ows->data_pin;
+}
+
+
+/**
+ * @brief Run the PIO engine's slots at standard or overdrive speed.
+ *        FROM 1.3.0
+ *
+ * @param ows:          Pointer to a OneWireState structure.
+ * @param is_overdrive: Use overdrive timing (`true`) or standard timing (`false`).
+ */
+static void ow_set_timing(OneWireState* ows, bool is_overdrive) {
+
+    ows->is_overdrive = is_overdrive;
+    ow_pio_start(ows);
+    pio_sm_set_clkdiv(OW_PIO, ows->pio_sm, (float)clock_get_hz(clk_sys) / (is_overdrive ? OW_PIO_OVERDRIVE_CYCLE_HZ : OW_PIO_CYCLE_HZ));
+}
+
+
+/**
+ * @brief Set the bus speed. Overdrive is entered by issuing Overdrive Skip ROM,
+ *        or Overdrive Match ROM and a device's ID, at standard speed; only
+ *        overdrive-capable devices respond. A standard-speed reset returns
+ *        every device to standard speed.
+ *        FROM 1.3.0
+ *
+ * @param ows:   Pointer to a OneWireState structure.
+ * @param speed: An OW_SPEED_* value.
+ * @param rom:   The device's 8-byte ID, LSB first, for OW_SPEED_OVERDRIVE_MATCH.
+ *
+ * @returns `true` if the speed was set, or `false` if there are no devices to set it for.
+ */
+bool ow_set_speed(OneWireState* ows, uint8_t speed, uint8_t* rom) {
+
+    ow_set_timing(ows, false);
+    bool devices_present = ow_reset(ows);
+    if (speed == OW_SPEED_STANDARD) return true;
+    if (!devices_present) return false;
+
+    if (speed == OW_SPEED_OVERDRIVE_SKIP) {
+        ow_write_byte(ows, OW_CMD_OVERDRIVE_SKIP_ROM);
+        ow_set_timing(ows, true);
+    } else {
+        // The ID follows at overdrive speed
+        ow_write_byte(ows, OW_CMD_OVERDRIVE_MATCH_ROM);
+        ow_set_timing(ows, true);
+        ow_write_bytes(ows, rom, OW_ROM_LENGTH_B);
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Run up to 24 write slots on the PIO engine, and wait for the
+ *        line samples taken during them. Writing 1s makes them read slots.
+ *        FROM 1.3.0
+ *
+ * @param ows:       Pointer to a OneWireState structure.
+ * @param bits:      The bits to send, LSB first.
+ * @param bit_count: The number of bits to send, 1-24.
+ *
+ * @returns The samples, the first in bit 0.
+ */
+static uint32_t ow_touch(OneWireState* ows, uint32_t bits, uint32_t bit_count) {
+
+    ow_pio_start(ows);
+    pio_sm_put_blocking(OW_PIO, ows->pio_sm, (bits << 8) | bit_count);
+    return pio_sm_get_blocking(OW_PIO, ows->pio_sm) >> (32 - bit_count);
+}
+
+
+/**
+ * @brief Zero the bus' performance counters.
+ *        FROM 1.3.0
+ *
+ * @param ows: Pointer to a OneWireState structure.
+ */
+void ow_clear_counters(OneWireState* ows) {
+
+    ows->bytes_written_total = 0;
+    ows->bytes_read_total = 0;
+}
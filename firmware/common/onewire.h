@@ -19,8 +19,11 @@
 #include <string.h>
 // Pico SDK Includes
 #include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
 // App Includes
 #include "serial.h"
+#include "onewire.pio.h"
 
 
 /*
@@ -56,9 +59,59 @@
 #define     OW_CMD_READ_ROM                 0x33
 #define     OW_CMD_SEARCH_ROM               0xF0
 #define     OW_CMD_MATCH_ROM                0x55
+// FROM 1.3.0
+#define     OW_CMD_OVERDRIVE_SKIP_ROM       0x3C
+#define     OW_CMD_OVERDRIVE_MATCH_ROM      0x69
+#define     OW_CMD_ALARM_SEARCH             0xEC
+
+// FROM 1.3.0
+// Search triplet results
+#define     OW_TRIPLET_ID_BIT               0x01    // The first bit read
+#define     OW_TRIPLET_CMP_BIT              0x02    // The second bit read, the first's complement
+#define     OW_TRIPLET_DIR_BIT              0x04    // The direction bit written
+#define     OW_SEARCH_FLAG_ALARM            0x01    // Only find devices in an alarm state
+#define     OW_FAMILY_ANY                   0x00
+
+// FROM 1.3.0
+// DS18B20 and compatible temperature sensors
+#define     OW_FAMILY_DS18B20               0x28
+#define     OW_FAMILY_DS1822                0x22
+#define     OW_FAMILY_DS1825                0x3B
+#define     OW_CMD_CONVERT_T                0x44
+#define     OW_CMD_READ_SCRATCHPAD          0xBE
+#define     OW_SCRATCHPAD_LENGTH_B          9
+#define     OW_CONVERT_TIMEOUT_MS           1000    // 750ms at 12-bit resolution, plus margin
+#define     OW_TEMP_FLAG_NO_CONVERT         0x01    // Request: read the last conversions only
+#define     OW_TEMP_FLAG_CONVERT_TIMEOUT    0x01    // Reply: the conversion never signalled completion
+#define     OW_TEMP_STATUS_OK               0x00
+#define     OW_TEMP_STATUS_NOT_PRESENT      0x01    // The scratchpad read as all 1s
+#define     OW_TEMP_STATUS_CRC_ERROR        0x02
+
+// FROM 1.3.0
+// Bus speed requests
+#define     OW_SPEED_STANDARD               0
+#define     OW_SPEED_OVERDRIVE_SKIP         1       // Put every device into overdrive
+#define     OW_SPEED_OVERDRIVE_MATCH        2       // Put one device, by ROM ID, into overdrive
+#define     OW_ROM_LENGTH_B                 8
+
+// FROM 1.3.0
+// CRC checks
+#define     OW_CRC_8                        8
+#define     OW_CRC_16                       16
+#define     OW_SEARCH_ATTEMPTS              3       // Tries per search step before an ID is dropped
+#define     OW_DEVICE_COUNT_MAX             64
 
 #define     DEFAULT_DATA_PIN                10
 
+// FROM 1.3.0
+// The bus is driven by a PIO state machine running onewire.pio.
+// NOTE The QTPy's ws2812 program uses pio1
+#define     OW_PIO                          pio0
+#define     OW_PIO_CYCLE_HZ                 1000000 // One cycle per microsecond
+#define     OW_PIO_OVERDRIVE_CYCLE_HZ       (uint32_t)(OW_PIO_CYCLE_HZ * DELAY_STANDARD_H_US / DELAY_OVERDRIVE_H_US)
+#define     OW_PIO_RESET_WORD               0       // A zero bit count
+#define     OW_PIO_FIFO_DEPTH               4       // Words in flight, so neither FIFO overfills
+
 
 /*
  * STRUCTURES
@@ -71,8 +124,26 @@ typedef struct {
     uint32_t    read_byte_count;
     uint32_t    current_device;             // Index into following array
     uint64_t    device_ids[64];
+    // FROM 1.3.0 -- performance counters
+    uint32_t    bytes_written_total;
+    uint32_t    bytes_read_total;
+    // FROM 1.3.0 -- PIO engine
+    int         pio_sm;                     // -1 until claimed
+    uint        pio_offset;
+    uint8_t     pio_pin;                    // The pin the state machine was set up for
+    bool        is_overdrive;               // Slots are run at overdrive speed
 } OneWireState;
 
+// FROM 1.3.0
+// One sensor's reading in the reply to OW_TEMPERATURES_CMD, which
+// begins with the record count and OW_TEMP_FLAG_* reply flags.
+// Little-endian, packed
+typedef struct __attribute__((packed)) {
+    uint64_t    rom;
+    int16_t     raw_temperature;            // In 1/16ths of a degree Celsius
+    uint8_t     status;                     // OW_TEMP_STATUS_* values
+} OW_Temperature_Record;
+
 
 /*
  * PROTOTYPES
@@ -82,9 +153,22 @@ bool        ow_reset(OneWireState* ows);
 bool        ow_configure(OneWireState* ows, uint32_t pin);
 void        ow_write_byte(OneWireState* ows, uint8_t byte_value);
 uint8_t     ow_read_byte(OneWireState* ows);
+// FROM 1.3.0
+void        ow_write_bytes(OneWireState* ows, uint8_t* data, uint32_t byte_count);
+void        ow_read_bytes(OneWireState* ows, uint8_t* buffer, uint32_t byte_count);
+bool        ow_set_speed(OneWireState* ows, uint8_t speed, uint8_t* rom);
+uint8_t     ow_triplet(OneWireState* ows, uint8_t direction);
+uint32_t    ow_search_devices(OneWireState* ows, uint8_t search_cmd, uint8_t family, uint64_t* ids, uint32_t id_count_max);
+void        ow_send_search(OneWireState* ows, uint8_t flags, uint8_t family);
+bool        ow_send_temperatures(OneWireState* ows, uint8_t flags);
+uint8_t     ow_crc8(uint8_t* data, uint32_t byte_count);
+uint16_t    ow_crc16(uint8_t* data, uint32_t byte_count, uint16_t crc);
+bool        ow_check_crc(uint8_t* data, uint32_t byte_count, uint8_t crc_type);
 void        ow_send_state(OneWireState* ows);
 void        ow_send_scan(OneWireState* ows);
 bool        is_pin_in_use_by_ow(OneWireState* ows, uint8_t pin);
+// FROM 1.3.0
+void        ow_clear_counters(OneWireState* ows);
 
 
 #endif      // _HEADER_ONE_WIRE_
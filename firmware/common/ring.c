@@ -0,0 +1,181 @@
+/*
+ * Depot RP2040 Bus Host Firmware - Byte ring buffer
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#include "ring.h"
+
+
+/*
+ * A single-producer, single-consumer byte ring. Head and tail are free-running
+ * counters, masked on access, so the ring can be filled completely. Puts and
+ * gets are all-or-nothing, so records written in one put can be read back
+ * whole.
+ */
+
+
+/*
+ * STATIC PROTOTYPES
+ */
+static void copy_in(Ring* ring, uint32_t offset, const uint8_t* data, uint32_t byte_count);
+static void copy_out(Ring* ring, uint8_t* data, uint32_t byte_count);
+
+
+/**
+ * @brief Prepare a ring for use.
+ *
+ * @param ring:    Pointer to the ring.
+ * @param storage: The ring's backing store.
+ * @param size:    The size of the backing store. Must be a power of two.
+ */
+void ring_init(Ring* ring, uint8_t* storage, uint32_t size) {
+
+    ring->data = storage;
+    ring->size = size;
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+
+/**
+ * @brief How many bytes are waiting in the ring.
+ *
+ * @param ring: Pointer to the ring.
+ *
+ * @returns The number of bytes.
+ */
+uint32_t ring_used(Ring* ring) {
+
+    return ring->head - ring->tail;
+}
+
+
+/**
+ * @brief How many bytes can be added to the ring.
+ *
+ * @param ring: Pointer to the ring.
+ *
+ * @returns The number of bytes.
+ */
+uint32_t ring_free(Ring* ring) {
+
+    return ring->size - (ring->head - ring->tail);
+}
+
+
+/**
+ * @brief Add bytes to the ring.
+ *
+ * @param ring:       Pointer to the ring.
+ * @param data:       The bytes to add.
+ * @param byte_count: The number of bytes to add.
+ *
+ * @returns `true` if the bytes were added, `false` if there wasn't room.
+ */
+bool ring_put(Ring* ring, const uint8_t* data, uint32_t byte_count) {
+
+    return ring_put_record(ring, data, byte_count, NULL, 0);
+}
+
+
+/**
+ * @brief Add a record made of a header and a body to the ring. The consumer
+ *        sees both parts at once, or neither.
+ *
+ * @param ring:         Pointer to the ring.
+ * @param header:       The header bytes.
+ * @param header_count: The number of header bytes.
+ * @param body:         The body bytes, or NULL.
+ * @param body_count:   The number of body bytes.
+ *
+ * @returns `true` if the record was added, `false` if there wasn't room.
+ */
+bool ring_put_record(Ring* ring, const uint8_t* header, uint32_t header_count, const uint8_t* body, uint32_t body_count) {
+
+    if (ring_free(ring) < header_count + body_count) return false;
+
+    copy_in(ring, 0, header, header_count);
+    if (body_count > 0) copy_in(ring, header_count, body, body_count);
+
+    // Publish the bytes only once they're in place
+    __sync_synchronize();
+    ring->head += header_count + body_count;
+    return true;
+}
+
+
+/**
+ * @brief Copy bytes from the ring without removing them.
+ *
+ * @param ring:       Pointer to the ring.
+ * @param data:       A buffer for the bytes.
+ * @param byte_count: The number of bytes to copy.
+ *
+ * @returns `true` if the bytes were copied, `false` if too few are waiting.
+ */
+bool ring_peek(Ring* ring, uint8_t* data, uint32_t byte_count) {
+
+    if (ring_used(ring) < byte_count) return false;
+    copy_out(ring, data, byte_count);
+    return true;
+}
+
+
+/**
+ * @brief Remove bytes from the ring.
+ *
+ * @param ring:       Pointer to the ring.
+ * @param data:       A buffer for the bytes, or NULL to discard them.
+ * @param byte_count: The number of bytes to remove.
+ *
+ * @returns `true` if the bytes were removed, `false` if too few are waiting.
+ */
+bool ring_get(Ring* ring, uint8_t* data, uint32_t byte_count) {
+
+    if (ring_used(ring) < byte_count) return false;
+    if (data != NULL) copy_out(ring, data, byte_count);
+
+    // Release the space only once the bytes have been read
+    __sync_synchronize();
+    ring->tail += byte_count;
+    return true;
+}
+
+
+/**
+ * @brief Copy bytes into the ring beyond its head.
+ *
+ * @param ring:       Pointer to the ring.
+ * @param offset:     Where to start, relative to the head.
+ * @param data:       The bytes to copy.
+ * @param byte_count: The number of bytes to copy.
+ */
+static void copy_in(Ring* ring, uint32_t offset, const uint8_t* data, uint32_t byte_count) {
+
+    uint32_t index = (ring->head + offset) & (ring->size - 1);
+    uint32_t first = ring->size - index;
+    if (first > byte_count) first = byte_count;
+    memcpy(ring->data + index, data, first);
+    memcpy(ring->data, data + first, byte_count - first);
+}
+
+
+/**
+ * @brief Copy bytes from the tail of the ring.
+ *
+ * @param ring:       Pointer to the ring.
+ * @param data:       A buffer for the bytes.
+ * @param byte_count: The number of bytes to copy.
+ */
+static void copy_out(Ring* ring, uint8_t* data, uint32_t byte_count) {
+
+    uint32_t index = ring->tail & (ring->size - 1);
+    uint32_t first = ring->size - index;
+    if (first > byte_count) first = byte_count;
+    memcpy(data, ring->data + index, first);
+    memcpy(data + first, ring->data, byte_count - first);
+}
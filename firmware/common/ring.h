@@ -0,0 +1,45 @@
+/*
+ * Depot RP2040 Bus Host Firmware - Byte ring buffer
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#ifndef _RING_HEADER_
+#define _RING_HEADER_
+
+
+/*
+ * INCLUDES
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+
+/*
+ * STRUCTURES
+ */
+typedef struct {
+    uint8_t*            data;
+    uint32_t            size;           // Must be a power of two
+    volatile uint32_t   head;           // Written only by the producer
+    volatile uint32_t   tail;           // Written only by the consumer
+} Ring;
+
+
+/*
+ * PROTOTYPES
+ */
+void        ring_init(Ring* ring, uint8_t* storage, uint32_t size);
+uint32_t    ring_used(Ring* ring);
+uint32_t    ring_free(Ring* ring);
+bool        ring_put(Ring* ring, const uint8_t* data, uint32_t byte_count);
+bool        ring_put_record(Ring* ring, const uint8_t* header, uint32_t header_count, const uint8_t* body, uint32_t body_count);
+bool        ring_peek(Ring* ring, uint8_t* data, uint32_t byte_count);
+bool        ring_get(Ring* ring, uint8_t* data, uint32_t byte_count);
+
+
+#endif  // _RING_HEADER_
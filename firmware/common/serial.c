@@ -18,7 +18,40 @@ static void         sig_handler(int signal);
 // FROM 1.1.2 -- make ack and err sends inline
 static inline void  send_ack(void);
 static inline void  send_err(void);
-static uint32_t     rx(uint8_t *buffer);
+static uint32_t     rx(uint8_t *buffer, char mode, bool* is_complete);
+// FROM 1.3.0
+static int          rx_byte(uint32_t timeout_us);
+static void         rx_skip(uint32_t byte_count);
+static uint32_t     frame_length(uint8_t status_byte, char mode);
+static void         tx_write_out(void);
+static void         process_frame(uint8_t* frame, uint32_t read_count);
+static void         write_bus_data(uint8_t* data, uint32_t byte_count);
+static void         read_bus_data(uint32_t byte_count);
+static void         transfer_bus_data(uint8_t* data, uint32_t byte_count);
+static inline uint32_t extended_length(uint8_t* frame);
+static void         queue_frame(uint8_t* frame, uint32_t read_count);
+static void         init_identity(void);
+static void         send_status_record(void);
+static void         run_frame(uint8_t* frame, uint32_t length, int sequence, uint8_t error_code, uint32_t received_us, bool more_queued);
+static void         run_program(uint8_t* program, uint32_t length);
+static bool         execute_program(uint8_t* program, uint32_t length, uint8_t* status, uint32_t* op_count, uint32_t* read_count);
+static bool         run_program_op(uint8_t* program, uint32_t length, uint32_t* index, uint32_t* read_count, uint8_t* status);
+static void         rx_notify(void* param);
+static void         count_frame(uint8_t status_byte, uint32_t latency_us);
+static void         clear_counters(void);
+static void         send_counters(uint8_t flags);
+static void         trace_frame(uint8_t* frame, uint32_t length, int sequence, uint32_t received_us, uint32_t duration_us);
+static void         send_trace(uint8_t flags);
+static void         start_sampling(uint8_t* data, uint32_t length);
+static void         stop_sampling(void);
+static bool         sample_timer_fired(repeating_timer_t* timer);
+static void         run_sample_job(void);
+static bool         is_program_valid(uint8_t* program, uint32_t length);
+static bool         is_job_deferred(uint8_t* program, uint32_t length);
+static void         send_program_result(SampleHeader* header, uint8_t* program, uint32_t length);
+static void         set_trigger(uint8_t* data, uint32_t length);
+static void         run_triggers(void);
+static void         run_jobs(void);
 // FROM 1.1.3
 static void         set_mode(char mode_key);
 
@@ -33,9 +66,68 @@ extern uint8_t I2C_PIN_PAIRS_BUS_1[];
 
 // FROM 1.2.0
 char supported_modes[MAX_NUMBER_OF_MODES] = { MODE_CODE_NONE };
-I2C_State i2c_state;
+// FROM 1.3.0 -- a state record for each I2C controller. I2C commands
+// act on the one selected by I2C_BUS_CMD or the last 'c' frame
+I2C_State i2c_states[2];
+I2C_State* i2c_state = &i2c_states[DEFAULT_I2C_BUS];
 OneWireState ow_state;
 GPIO_State gpio_state;
+// FROM 1.3.0
+SPI_State spi_state;
+UART_State uart_state;
+
+// FROM 1.3.0
+// A byte read ahead of the current frame, returned to the next `rx_byte()` call
+static int rx_lookahead = PICO_ERROR_TIMEOUT;
+
+// FROM 1.3.0
+// Outgoing data is queued here and written out a USB packet at a time
+static uint8_t tx_buffer[TX_BUFFER_LENGTH_B];
+static uint32_t tx_byte_count = 0;
+
+// FROM 1.3.0
+// Set by stdio when the host sends data
+static volatile bool rx_pending = true;
+
+// FROM 1.3.0
+// Extended frames are too large for the stack, and the bus
+// helper functions need the current mode and error state
+static uint8_t rx_buffer[RX_BUFFER_LENGTH_B];
+static uint8_t bus_rx_buffer[BUS_RX_BUFFER_LENGTH_B];
+// NOTE The mode is set on core 1, but core 0 reads it to size frames
+static volatile uint8_t current_mode = MODE_CODE_I2C;
+static uint last_error_code = GEN_NO_ERROR;
+
+// FROM 1.3.0
+// Performance counters, only accessed on core 1. Bus byte and
+// error totals are kept in the bus modules' state records
+static uint32_t perf_counts[PERF_COMMAND_SLOTS];
+static uint32_t perf_latency[PERF_COMMAND_SLOTS][PERF_HISTOGRAM_BUCKETS];
+static uint32_t perf_rejected_frames = 0;
+static uint64_t perf_cleared_us = 0;
+
+// FROM 1.3.0
+// The window sequence number of the frame core 1 is running,
+// and the error it failed with, for the trace
+static int reply_sequence = NO_SEQUENCE;
+static uint8_t frame_result = GEN_NO_ERROR;
+
+// FROM 1.3.0
+// The sampling job. Its timer fires on core 0, which flags
+// the sample as due; core 1 runs the job's program
+static uint8_t sample_program[SAMPLE_PROGRAM_MAX_B];
+static uint32_t sample_program_length = 0;
+static uint16_t sample_sequence = 0;
+static bool sample_is_running = false;
+static repeating_timer_t sample_timer;
+static volatile bool sample_due = false;
+static volatile bool sample_overrun = false;
+static volatile uint32_t sample_due_us = 0;
+
+// FROM 1.3.0
+// Identity data is fixed, so get it once, at boot
+static BoardIdentity board_identity;
+static StatusRecord status_record;
 
 
 /**
@@ -50,19 +142,35 @@ void rx_loop(void) {
     // Trap certain signals
     signal(SIGABRT | SIGSEGV | SIGBUS | SIGTRAP | SIGSYS, sig_handler);
 
+
     // Prepare a UART RX buffer
-    uint8_t rx_buffer[RX_BUFFER_LENGTH_B] = {0};
     uint32_t read_count = 0;
-    bool do_use_led = true;
+    bool is_frame_complete = true;
 
     // Prepare a transaction record with default data
-    i2c_state.is_started = false;                         // No transaction taking place
-    i2c_state.is_ready = false;                           // I2C bus not yet initialised
-    i2c_state.frequency = 400;                            // The bud frequency in use
-    i2c_state.address = 0xFF;                             // The target I2C address
-    i2c_state.bus = DEFAULT_I2C_BUS == 0 ? i2c0 : i2c1;   // The I2C bus to use
-    i2c_state.sda_pin = DEFAULT_SDA_PIN;                  // The I2C SDA pin
-    i2c_state.scl_pin = DEFAULT_SCL_PIN;                  // The I2C SCL pin
+    // FROM 1.3.0 -- for both controllers. The one that's not the board's
+    //               default gets the first pins listed for it
+    for (uint32_t i = 0 ; i < 2 ; ++i) {
+        I2C_State* its = &i2c_states[i];
+        its->is_started = false;                            // No transaction taking place
+        its->is_ready = false;                              // I2C bus not yet initialised
+        its->frequency = 400;                               // The bud frequency in use
+        its->address = 0xFF;                                // The target I2C address
+        its->dma_tx_channel = -1;                           // FROM 1.3.0 -- DMA channels not yet claimed
+        its->dma_rx_channel = -1;
+        its->dma_is_busy = false;
+        its->bus = i == 0 ? i2c0 : i2c1;                    // The I2C bus to use
+        if (i == DEFAULT_I2C_BUS) {
+            its->sda_pin = DEFAULT_SDA_PIN;                 // The I2C SDA pin
+            its->scl_pin = DEFAULT_SCL_PIN;                 // The I2C SCL pin
+        } else {
+            uint8_t* pin_pairs = i == 0 ? I2C_PIN_PAIRS_BUS_0 : I2C_PIN_PAIRS_BUS_1;
+            its->sda_pin = pin_pairs[0];
+            its->scl_pin = pin_pairs[1];
+        }
+    }
+
+    i2c_state = &i2c_states[DEFAULT_I2C_BUS];
 
     // FROM 1.1.0 -- record GPIO pin state
     memset(gpio_state.state_map, 0, GPIO_PIN_MAX + 1);
@@ -72,461 +180,1731 @@ void rx_loop(void) {
     ow_state.data_pin = DEFAULT_DATA_PIN;
     ow_state.current_device = 0;
     ow_state.device_count = 0;
+    ow_state.pio_sm = -1;                                 // FROM 1.3.0 -- PIO engine not yet loaded
+    ow_state.is_overdrive = false;                        // FROM 1.3.0
+
+    // FROM 1.3.0 -- record SPI state
+    spi_state.is_ready = false;
+    spi_state.is_selected = false;
+    spi_state.bus = DEFAULT_SPI_BUS == 0 ? spi0 : spi1;
+    spi_state.sck_pin = DEFAULT_SPI_SCK_PIN;
+    spi_state.tx_pin = DEFAULT_SPI_TX_PIN;
+    spi_state.rx_pin = DEFAULT_SPI_RX_PIN;
+    spi_state.cs_pin = DEFAULT_SPI_CS_PIN;
+    spi_state.mode = 0;
+    spi_state.baud_khz = SPI_DEFAULT_BAUD_KHZ;
+    spi_state.dma_tx_channel = -1;
+    spi_state.dma_rx_channel = -1;
+
+    // FROM 1.3.0 -- record UART bridge state
+    uart_state.is_ready = false;
+    uart_state.bus = DEFAULT_UART_BUS == 0 ? uart0 : uart1;
+    uart_state.tx_pin = DEFAULT_UART_TX_PIN;
+    uart_state.rx_pin = DEFAULT_UART_RX_PIN;
+    uart_state.baud = UART_DEFAULT_BAUD;
+    uart_state.data_bits = 8;
+    uart_state.stop_bits = 1;
+    uart_state.parity = UART_PARITY_NONE;
+    uart_state.dma_rx_channel = -1;
+    uart_state.dma_tx_channel = -1;
 
     // FROM 1.1.3
     // Default current mode to I2C, for backwards compatibility
     // NOTE Call the function so the LED colour is correctly set
-    uint8_t current_mode = MODE_CODE_I2C;
+    current_mode = MODE_CODE_I2C;
     supported_modes[0] = MODE_CODE_I2C;
     supported_modes[1] = MODE_CODE_ONE_WIRE;
+    supported_modes[2] = MODE_CODE_SPI;
+    supported_modes[3] = MODE_CODE_UART;
     set_mode(MODE_CODE_I2C);
 
-    // FROM 1.1.3
-    uint last_error_code = GEN_NO_ERROR;
+    // FROM 1.3.0
+    // Cache the board's identity
+    init_identity();
+    clear_counters();
+
+    // FROM 1.3.0
+    // Run the bus engines on core 1. From here on, core 0 only
+    // handles USB and framing, and must not call `tx()`
+    engine_init(run_frame, run_jobs);
 
-    // Heartbeat variables
-    uint64_t last = time_us_64();
-    bool is_on = false;
+    // FROM 1.3.0
+    // Wake the loop whenever the host sends data
+    transport_set_rx_callback(rx_notify);
+
+    // FROM 1.3.0
+    // Drive the LED, including the heartbeat, from a core 0 timer,
+    // never from command processing
+    led_engine_init();
+#ifdef SHOW_HEARTBEAT
+    led_set_heartbeat(true);
+#endif
 
     while(1) {
         // Scan for input
-        read_count = rx(rx_buffer);
+        read_count = rx(rx_buffer, current_mode, &is_frame_complete);
+
+        // FROM 1.3.0
+        // Reject frames whose tail didn't arrive in time, under their
+        // window sequence number if that arrived
+        if (read_count > 0 && !is_frame_complete) {
+            bool has_sequence = (rx_buffer[0] == WINDOW_FRAME_CMD && read_count >= 2);
+            engine_reject(has_sequence ? rx_buffer[1] : NO_SEQUENCE, GEN_INCOMPLETE_FRAME);
+            memset(rx_buffer, 0, read_count);
+            read_count = 0;
+        }
 
         // Did we receive anything?
         if (read_count > 0) {
-            // Are we expecting write data or a read op next?
-            // NOTE The first byte will always be:
-            //      32-127  (ascii char as a command),
-            //      128-191 (read 1-64 bytes), or
-            //      192-255 (write 1-64 bytes)
-            uint8_t status_byte = rx_buffer[0];
-            uint8_t* rx_ptr = rx_buffer;
-
-            if (status_byte >= READ_LENGTH_BASE) {
-                // We have data or a read op
-                if (status_byte >= WRITE_LENGTH_BASE) {
-                    // Write data received, so send it and ACK
-                    switch(current_mode){
-                        case MODE_CODE_I2C:
-                            if (i2c_state.is_started) {
-                                i2c_state.write_byte_count = status_byte - WRITE_LENGTH_BASE + 1;
+            // FROM 1.3.0
+            // Pass the frame to core 1, unwrapping windowed frames
+            if (rx_buffer[0] == WINDOW_FRAME_CMD) {
+                queue_frame(rx_buffer, read_count);
+            } else {
+                engine_submit(rx_buffer, read_count, NO_SEQUENCE);
+            }
+
+            // Clear buffer and listen for input
+            memset(rx_buffer, 0, read_count);
+        }
+
+        // FROM 1.3.0
+        // Send the host whatever core 1 has replied so far
+        engine_pump();
+
+        // FROM 1.3.0
+        // Nothing received? Sleep until the host sends more or core 1 replies.
+        // NOTE `rx_notify()` and core 1 signal an event, so if either happens
+        //      after the check, `__wfe()` returns immediately
+        if (read_count == 0) {
+            while (!rx_pending && !engine_has_replies()) {
+                transport_task();
+                if (!rx_pending && !engine_has_replies()) __wfe();
+            }
+
+            rx_pending = false;
+        }
+    }
+
+    // Should not get here, but just in case...
+    // Signal an error on the host's LED
+    led_set_colour(0xFF0000);
+    led_on();
+
+    // Fall out of the firmware at this point...
+}
+
+
+/**
+ * @brief Act on a single command or data frame from the host.
+ *        FROM 1.3.0 -- split out of `rx_loop()` so queued frames can
+ *        be processed too.
+ *
+ * @param frame:      The frame's bytes.
+ * @param read_count: The frame's length in bytes.
+ */
+static void process_frame(uint8_t* frame, uint32_t read_count) {
+
+    // Are we expecting write data or a read op next?
+    // NOTE The first byte will always be:
+    //      32-127  (ascii char as a command),
+    //      128-191 (read 1-64 bytes), or
+    //      192-255 (write 1-64 bytes)
+    uint8_t status_byte = frame[0];
+    uint8_t* rx_ptr = frame;
+
+    if (status_byte >= READ_LENGTH_BASE) {
+        // We have data or a read op
+        if (status_byte >= WRITE_LENGTH_BASE) {
+            // Write data received, so send it and ACK
+            write_bus_data(&frame[1], status_byte - WRITE_LENGTH_BASE + 1);
+        } else {
+            // Read length received only
+            read_bus_data(status_byte - READ_LENGTH_BASE + 1);
+        }
+    } else {
+        // Maybe we received a command
+        char cmd = (char)status_byte;
+
 #ifdef DO_UART_DEBUG
-                                debug_log("Bytes to write: %i", i2c_state.write_byte_count);
+        debug_log("Command received: %c 0x%02X", cmd, status_byte);
 #endif
-                                int bytes_sent = i2c_write_timeout_us(i2c_state.bus, i2c_state.address, &rx_buffer[1], i2c_state.write_byte_count, false, 1000);
-#ifdef DO_UART_DEBUG
-                                debug_log("Bytes sent: %i", bytes_sent);
+
+        switch(cmd) {
+            /*
+             * FIRMWARE COMMANDS
+             */
+
+            // FROM 1.1.1 -- change command from z to !
+            case 'z':   // REMOVE IN 1.2.0
+            case '!':   // RESPOND TO CONNECTION REQUEST
+                // FROM 1.2.0
+                // Replace the 'hello' string with backwards compatible
+                // data that includes a firmware version indicator.
+                // This saves code an explicit request for info, which in
+                // any case is intended to be human-readable only.
+                // This will be useful for future apps to detect which
+                // firmware they're talking to.
+                // FROM 1.3.0 -- automated from cmake
+                {
+                    uint8_t hello[4] = {'O', 'K', FW_VERSION[0], FW_VERSION[2]};
+                    tx(hello, 4);
+                }
+                break;
+
+            // FROM 1.1.0
+            case '*':   // SET LED STATE
+#ifdef SHOW_HEARTBEAT
+                led_set_heartbeat(frame[1] == 1);
+                send_ack();
+#else
+                last_error_code = GEN_LED_NOT_ENABLED;
+                send_err();
 #endif
-                                // Send an ACK to say we wrote the data -- or an ERR if we didn't
-                                if (bytes_sent != PICO_ERROR_GENERIC && bytes_sent != PICO_ERROR_TIMEOUT) {
-                                    send_ack();
-                                    break;
-                                }
-                            }
+                break;
+
+            // FROM 1.3.0
+            case STATUS_CMD:    // GET BINARY STATUS
+                send_status_record();
+                break;
+
+            // FROM 1.3.0
+            case PERF_CMD:      // GET, AND OPTIONALLY CLEAR, PERFORMANCE COUNTERS
+                send_counters(frame[1]);
+                break;
+
+            // FROM 1.3.0
+            case TRACE_CMD:     // GET, AND OPTIONALLY CLEAR, THE COMMAND TRACE
+                send_trace(frame[1]);
+                break;
+
+            case '?':   // GET STATUS
+                switch(current_mode) {
+                    case MODE_CODE_I2C:
+                        send_i2c_status(i2c_state);
+                        break;
+                    case MODE_CODE_ONE_WIRE:
+                        ow_send_state(&ow_state);
+                        break;
+                    case MODE_CODE_SPI:
+                        send_spi_status(&spi_state);
+                        break;
+                    case MODE_CODE_UART:
+                        send_uart_status(&uart_state);
+                        break;
+                    default:
+                        last_error_code = GEN_UNKNOWN_MODE;
+                        send_err();
+                }
+                break;
 
-                            // Error
-                            last_error_code = I2C_COULD_NOT_WRITE;
-                            send_err();
-                            break;
-                        case MODE_CODE_ONE_WIRE:
-                            if (ow_state.is_ready) {
-                                ow_state.write_byte_count = status_byte - WRITE_LENGTH_BASE + 1;
+            // FROM 1.1.3
+            case '$':   // GET LAST ERROR
+                {
+                    uint8_t err_buffer[3] = {(uint8_t)last_error_code, '\r', '\n'};
+                    tx(err_buffer, 3);
 #ifdef DO_UART_DEBUG
-                                debug_log("Bytes to write: %i", ow_state.write_byte_count);
+                    debug_log("Error code reported: %02X", last_error_code);
 #endif
-                                for (uint32_t i = 0 ; i < ow_state.write_byte_count ; ++i) {
-                                    ow_write_byte(&ow_state, rx_buffer[i + 1]);
+                }
+                break;
+
+            // FROM 1.2.0
+            case '#':   // SET CURRENT MODE
+                {
+                    char new_mode = rx_ptr[1];
+                    bool is_mode_supported = false;
+                    for (uint32_t i = 0 ; i < MAX_NUMBER_OF_MODES ; ++i) {
+                        if (supported_modes[i] != MODE_CODE_NONE && supported_modes[i] == new_mode) {
+                            is_mode_supported = true;
+                            break;
+                        }
+                    }
+
+                    if (is_mode_supported) {
+                        current_mode = new_mode;
+                        set_mode(new_mode);
+                        send_ack();
 #ifdef DO_UART_DEBUG
-                                debug_log("Written: %02X", rx_buffer[i + 1]);
+                        debug_log("Mode set to: %02X", current_mode);
 #endif
-                                }
+                    } else {
+                        last_error_code = GEN_UNKNOWN_MODE;
+                        send_err();
+                    }
 
-                                send_ack();
-                            } else {
-                                last_error_code = OW_NOT_READY;
-                                send_err();
-                            }
-                            break;
-                        default:
-                            last_error_code = GEN_UNKNOWN_MODE;
-                            send_err();
+                    break;
+                }
+            // FROM 1.3.0
+            case 'W':   // EXTENDED WRITE
+                {
+                    uint32_t byte_count = extended_length(frame);
+                    if (byte_count > 0 && byte_count <= EXTENDED_FRAME_MAX_B && read_count >= EXTENDED_HEADER_LENGTH_B + byte_count) {
+                        write_bus_data(&frame[EXTENDED_HEADER_LENGTH_B], byte_count);
+                    } else {
+                        last_error_code = GEN_BAD_FRAME_LENGTH;
+                        send_err();
                     }
-                } else {
-                    // Read length received only
-                    uint8_t bus_rx_buffer[BUS_RX_BUFFER_LENGTH_B] = {0};
-                    switch(current_mode){
+                }
+                break;
+
+            case 'R':   // EXTENDED READ
+                {
+                    uint32_t byte_count = extended_length(frame);
+                    if (byte_count > 0 && byte_count <= EXTENDED_FRAME_MAX_B) {
+                        read_bus_data(byte_count);
+                    } else {
+                        last_error_code = GEN_BAD_FRAME_LENGTH;
+                        send_err();
+                    }
+                }
+                break;
+
+            // FROM 1.3.0
+            case PROGRAM_CMD:   // RUN A TRANSACTION PROGRAM
+                {
+                    uint32_t byte_count = extended_length(frame);
+                    if (byte_count > 0 && byte_count <= EXTENDED_FRAME_MAX_B && read_count >= EXTENDED_HEADER_LENGTH_B + byte_count) {
+                        run_program(&frame[EXTENDED_HEADER_LENGTH_B], byte_count);
+                    } else {
+                        last_error_code = GEN_BAD_FRAME_LENGTH;
+                        send_err();
+                    }
+                }
+                break;
+
+            // FROM 1.3.0
+            case SAMPLE_CMD:    // START OR STOP A SAMPLING JOB
+                {
+                    uint32_t byte_count = extended_length(frame);
+                    if (byte_count == 0) {
+                        stop_sampling();
+                    } else if (byte_count > SAMPLE_PERIOD_LENGTH_B && byte_count <= SAMPLE_PERIOD_LENGTH_B + SAMPLE_PROGRAM_MAX_B && read_count >= EXTENDED_HEADER_LENGTH_B + byte_count) {
+                        start_sampling(&frame[EXTENDED_HEADER_LENGTH_B], byte_count);
+                    } else {
+                        last_error_code = GEN_BAD_FRAME_LENGTH;
+                        send_err();
+                    }
+                }
+                break;
+
+            // FROM 1.3.0
+            case TRIGGER_CMD:   // ARM OR DISARM A PIN TRIGGER
+                {
+                    uint32_t byte_count = extended_length(frame);
+                    if ((byte_count == 1 || (byte_count > TRIGGER_HEADER_LENGTH_B && byte_count <= TRIGGER_HEADER_LENGTH_B + GPIO_TRIGGER_PROGRAM_MAX_B)) && read_count >= EXTENDED_HEADER_LENGTH_B + byte_count) {
+                        set_trigger(&frame[EXTENDED_HEADER_LENGTH_B], byte_count);
+                    } else {
+                        last_error_code = GEN_BAD_FRAME_LENGTH;
+                        send_err();
+                    }
+                }
+                break;
+
+            // FROM 1.3.0
+            case SPI_TRANSFER_CMD:  // FULL-DUPLEX SPI TRANSFER
+                {
+                    uint32_t byte_count = extended_length(frame);
+                    if (byte_count > 0 && byte_count <= EXTENDED_FRAME_MAX_B && read_count >= EXTENDED_HEADER_LENGTH_B + byte_count) {
+                        transfer_bus_data(&frame[EXTENDED_HEADER_LENGTH_B], byte_count);
+                    } else {
+                        last_error_code = GEN_BAD_FRAME_LENGTH;
+                        send_err();
+                    }
+                }
+                break;
+
+            // FROM 1.3.0
+            case UART_READ_CMD: // SEND WHATEVER THE UART HAS RECEIVED
+                {
+                    uint32_t byte_count = extended_length(frame);
+                    if (current_mode != MODE_CODE_UART) {
+                        last_error_code = GEN_UNKNOWN_MODE;
+                        send_err();
+                    } else if (!uart_state.is_ready) {
+                        last_error_code = UART_NOT_STARTED;
+                        send_err();
+                    } else if (byte_count > 0 && byte_count <= EXTENDED_FRAME_MAX_B) {
+                        send_uart_data(&uart_state, byte_count);
+                    } else {
+                        last_error_code = GEN_BAD_FRAME_LENGTH;
+                        send_err();
+                    }
+                }
+                break;
+
+            /*
+             * MULTI-BUS COMMANDS
+             */
+
+            // FROM 1.1.0
+            case 'c':   // CONFIGURE THE BUS AND PINS
+                {
+                    bool success = false;
+                    uint32_t possible_error = GEN_NO_ERROR;
+                    switch(current_mode) {
                         case MODE_CODE_I2C:
-                            if (i2c_state.is_started) {
-                                i2c_state.read_byte_count = status_byte - READ_LENGTH_BASE + 1;
-
-                                int bytes_read = i2c_read_timeout_us(i2c_state.bus, i2c_state.address, bus_rx_buffer, i2c_state.read_byte_count, false, 1000);
-
-                                // Return the read data
-                                if (bytes_read != PICO_ERROR_GENERIC) {
-                                    tx(bus_rx_buffer, i2c_state.read_byte_count);
-                                    break;
-                                }
+                            // FROM 1.3.0 -- configure the named controller,
+                            //               and select it
+                            {
+                                I2C_State* its = &i2c_states[frame[1] & 0x01];
+                                success = configure_i2c(its, &frame[1]);
+                                if (success) i2c_state = its;
+                                possible_error = I2C_COULD_NOT_CONFIGURE;
                             }
-                            last_error_code = I2C_COULD_NOT_READ;
                             break;
                         case MODE_CODE_ONE_WIRE:
-                            if (ow_state.is_ready) {
-                                ow_state.read_byte_count = status_byte - READ_LENGTH_BASE + 1;
-
-                                for (uint32_t i = 0 ; i < ow_state.read_byte_count ; ++i) {
-                                    bus_rx_buffer[i] = ow_read_byte(&ow_state);
-#ifdef DO_UART_DEBUG
-                                    debug_log("Read: %02X", bus_rx_buffer[i]);
-#endif
-                                }
-
-                                tx(bus_rx_buffer, ow_state.read_byte_count);
-                            }
+                            success = ow_configure(&ow_state, frame[1]);
+                            possible_error = OW_COULD_NOT_CONFIGURE;
+                            break;
+                        // FROM 1.3.0
+                        case MODE_CODE_SPI:
+                            success = configure_spi(&spi_state, &frame[1]);
+                            possible_error = SPI_COULD_NOT_CONFIGURE;
+                            break;
+                        case MODE_CODE_UART:
+                            success = configure_uart(&uart_state, &frame[1]);
+                            possible_error = UART_COULD_NOT_CONFIGURE;
                             break;
                         default:
                             last_error_code = GEN_UNKNOWN_MODE;
                             send_err();
                     }
-                }
-            } else {
-                // Maybe we received a command
-                char cmd = (char)status_byte;
-
-#ifdef DO_UART_DEBUG
-                debug_log("Command received: %c 0x%02X", cmd, status_byte);
-#endif
-
-                switch(cmd) {
-                    /*
-                     * FIRMWARE COMMANDS
-                     */
-
-                    // FROM 1.1.1 -- change command from z to !
-                    case 'z':   // REMOVE IN 1.2.0
-                    case '!':   // RESPOND TO CONNECTION REQUEST
-                        // FROM 1.2.0
-                        // Replace the 'hello' string with backwards compatible
-                        // data that includes a firmware version indicator.
-                        // This saves code an explicit request for info, which in
-                        // any case is intended to be human-readable only.
-                        // This will be useful for future apps to detect which
-                        // firmware they're talking to.
-                        // TODO Automate from cmake
-                        tx("OK12", 4);
-                        break;
 
-                    // FROM 1.1.0
-                    case '*':   // SET LED STATE
-                        do_use_led = rx_buffer[1] == 1 ? true : false;
-#ifdef SHOW_HEARTBEAT
+                    if (success) {
                         send_ack();
-#else
-                        last_error_code = GEN_LED_NOT_ENABLED;
+                    } else {
+                        last_error_code = possible_error;
                         send_err();
-#endif
-                        break;
-
-                    case '?':   // GET STATUS
-                        switch(current_mode) {
-                            case MODE_CODE_I2C:
-                                send_i2c_status(&i2c_state);
-                                break;
-                            case MODE_CODE_ONE_WIRE:
-                                ow_send_state(&ow_state);
-                                break;
-                            default:
-                                last_error_code = GEN_UNKNOWN_MODE;
-                                send_err();
-                        }
+                    }
+                }
+                break;
+
+            case 'd':   // SCAN THE CURRENT BUS FOR DEVICES
+                        // BUSES SUPPORTED: I2C, ONE-WIRE
+                switch(current_mode) {
+                    case MODE_CODE_I2C:
+                        if (!i2c_state->is_ready) init_i2c(i2c_state);
+                        send_i2c_scan(i2c_state);
                         break;
-
-                    // FROM 1.1.3
-                    case '$':   // GET LAST ERROR
-                        {
-                            uint8_t err_buffer[3] = {(uint8_t)last_error_code, '\r', '\n'};
-                            tx(err_buffer, 3);
-#ifdef DO_UART_DEBUG
-                            debug_log("Error code reported: %02X", last_error_code);
-#endif
-                        }
+                    case MODE_CODE_ONE_WIRE:
+                        ow_send_scan(&ow_state);
                         break;
+                    default:
+                        last_error_code = GEN_UNKNOWN_MODE;
+                        send_err();
+                }
+                break;
 
-                    // FROM 1.2.0
-                    case '#':   // SET CURRENT MODE
-                        {
-                            char new_mode = rx_ptr[1];
-                            bool is_mode_supported = false;
-                            for (uint32_t i = 0 ; i < MAX_NUMBER_OF_MODES ; ++i) {
-                                if (supported_modes[i] != MODE_CODE_NONE && supported_modes[i] == new_mode) {
-                                    is_mode_supported = true;
-                                    break;
-                                }
-                            }
+            // FROM 1.3.0
+            case 'E':   // FAST-SCAN AN I2C ADDRESS RANGE, ONE OR BOTH BUSES
+                if (current_mode == MODE_CODE_I2C) {
+                    if (!i2c_state->is_ready) init_i2c(i2c_state);
+                    send_i2c_fast_scan(i2c_state, frame);
+                } else {
+                    last_error_code = GEN_UNKNOWN_MODE;
+                    send_err();
+                }
+                break;
 
-                            if (is_mode_supported) {
-                                current_mode = new_mode;
-                                set_mode(new_mode);
-                                send_ack();
-#ifdef DO_UART_DEBUG
-                                debug_log("Mode set to: %02X", current_mode);
-#endif
-                            } else {
-                                last_error_code = GEN_UNKNOWN_MODE;
+            // FROM 1.3.0
+            case 'D':   // SCAN THE I2C BUS, RETURNING A BITMAP
+                if (current_mode == MODE_CODE_I2C) {
+                    if (!i2c_state->is_ready) init_i2c(i2c_state);
+                    send_i2c_scan_bitmap(i2c_state);
+                } else {
+                    last_error_code = GEN_UNKNOWN_MODE;
+                    send_err();
+                }
+                break;
+
+            case 'i':   // INITIALISE THE CURRENT BUS:
+                        // BUSES SUPPORTED: I2C, ONE-WIRE
+                switch(current_mode) {
+                    case MODE_CODE_I2C:
+                        // No need it initialise if we already have
+                        if (!i2c_state->is_ready) {
+                            // Are the pins already taken?
+                            if ((is_pin_taken(i2c_state->scl_pin) & ~PIN_USAGE_FIELD_I2C) > 0 ||
+                                (is_pin_taken(i2c_state->sda_pin) & ~PIN_USAGE_FIELD_I2C) > 0) {
+                                last_error_code = I2C_PINS_ALREADY_IN_USE;
                                 send_err();
+                                break;
                             }
 
+                            // Initialise the bus
+                            init_i2c(i2c_state);
+                        }
+                        send_ack();
+                        break;
+                    case MODE_CODE_ONE_WIRE:
+                        // Is the data pin already taken?
+                        if ((is_pin_taken(ow_state.data_pin) & ~PIN_USAGE_FIELD_ONEWIRE) > 0) {
+                            last_error_code = OW_PIN_ALREADY_IN_USE;
+                            send_err();
                             break;
                         }
-                    /*
-                     * MULTI-BUS COMMANDS
-                     */
-
-                    // FROM 1.1.0
-                    case 'c':   // CONFIGURE THE BUS AND PINS
-                        {
-                            bool success = false;
-                            uint32_t possible_error = GEN_NO_ERROR;
-                            switch(current_mode) {
-                                case MODE_CODE_I2C:
-                                    success = configure_i2c(&i2c_state, &rx_buffer[1]);
-                                    possible_error = I2C_COULD_NOT_CONFIGURE;
-                                    break;
-                                case MODE_CODE_ONE_WIRE:
-                                    success = ow_configure(&ow_state, rx_buffer[1]);
-                                    possible_error = OW_COULD_NOT_CONFIGURE;
-                                    break;
-                                default:
-                                    last_error_code = GEN_UNKNOWN_MODE;
-                                    send_err();
-                            }
 
-                            if (success) {
-                                send_ack();
-                            } else {
-                                last_error_code = possible_error;
-                                send_err();
-                            }
+                        // Initialise the bus
+                        ow_init(&ow_state);
+                        if (ow_state.is_ready) {
+                            send_ack();
+                        } else {
+                            last_error_code = OW_NO_DEVICES_FOUND;
+                            send_err();
                         }
                         break;
-
-                    case 'd':   // SCAN THE CURRENT BUS FOR DEVICES
-                                // BUSES SUPPORTED: I2C, ONE-WIRE
-                        switch(current_mode) {
-                            case MODE_CODE_I2C:
-                                if (!i2c_state.is_ready) init_i2c(&i2c_state);
-                                send_i2c_scan(&i2c_state);
-                                break;
-                            case MODE_CODE_ONE_WIRE:
-                                ow_send_scan(&ow_state);
-                                break;
-                            default:
-                                last_error_code = GEN_UNKNOWN_MODE;
+                    // FROM 1.3.0
+                    case MODE_CODE_SPI:
+                        if (!spi_state.is_ready) {
+                            // Are the pins already taken?
+                            if ((is_pin_taken(spi_state.sck_pin) & ~PIN_USAGE_FIELD_SPI) > 0 ||
+                                (is_pin_taken(spi_state.tx_pin) & ~PIN_USAGE_FIELD_SPI) > 0 ||
+                                (is_pin_taken(spi_state.rx_pin) & ~PIN_USAGE_FIELD_SPI) > 0 ||
+                                (is_pin_taken(spi_state.cs_pin) & ~PIN_USAGE_FIELD_SPI) > 0) {
+                                last_error_code = SPI_PINS_ALREADY_IN_USE;
                                 send_err();
-                        }
-                        break;
-
-                    case 'i':   // INITIALISE THE CURRENT BUS:
-                                // BUSES SUPPORTED: I2C, ONE-WIRE
-                        switch(current_mode) {
-                            case MODE_CODE_I2C:
-                                // No need it initialise if we already have
-                                if (!i2c_state.is_ready) {
-                                    // Are the pins already taken?
-                                    if ((is_pin_taken(i2c_state.scl_pin) & ~PIN_USAGE_FIELD_I2C) > 0 ||
-                                        (is_pin_taken(i2c_state.sda_pin) & ~PIN_USAGE_FIELD_I2C) > 0) {
-                                        last_error_code = I2C_PINS_ALREADY_IN_USE;
-                                        send_err();
-                                        break;
-                                    }
-
-                                    // Initialise the bus
-                                    init_i2c(&i2c_state);
-                                }
-                                send_ack();
                                 break;
-                            case MODE_CODE_ONE_WIRE:
-                                // Is the data pin already taken?
-                                if ((is_pin_taken(ow_state.data_pin) & ~PIN_USAGE_FIELD_ONEWIRE) > 0) {
-                                    last_error_code = OW_PIN_ALREADY_IN_USE;
-                                    send_err();
-                                    break;
-                                }
-
-                                // Initialise the bus
-                                ow_init(&ow_state);
-                                if (ow_state.is_ready) {
-                                    send_ack();
-                                } else {
-                                    last_error_code = OW_NO_DEVICES_FOUND;
-                                    send_err();
-                                }
-                                break;
-                            default:
-                                last_error_code = GEN_UNKNOWN_MODE;
-                                send_err();
-                        }
-                        break;
+                            }
 
-                    case 'x':   // RESET BUS
-                        switch(current_mode) {
-                            case MODE_CODE_I2C:
-                                i2c_state.is_started = false;
-                                reset_i2c(&i2c_state);
-                                send_ack();
-                                break;
-                            case MODE_CODE_ONE_WIRE:
-                                ow_reset(&ow_state);
-                                send_ack();
-                                break;
-                            default:
-                                last_error_code = GEN_UNKNOWN_MODE;
-                                send_err();
+                            init_spi(&spi_state);
                         }
+                        send_ack();
                         break;
-
-                    // FROM 1.1.3
-                    case 'k':   // DEINIT BUS
-                        switch(current_mode) {
-                            case MODE_CODE_I2C:
-                                deinit_i2c(&i2c_state);
-                                send_ack();
-                                break;
-                            default:
-                                last_error_code = GEN_UNKNOWN_MODE;
+                    // FROM 1.3.0
+                    case MODE_CODE_UART:
+                        if (!uart_state.is_ready) {
+                            // Are the pins already taken?
+                            if ((is_pin_taken(uart_state.tx_pin) & ~PIN_USAGE_FIELD_UART) > 0 ||
+                                (is_pin_taken(uart_state.rx_pin) & ~PIN_USAGE_FIELD_UART) > 0) {
+                                last_error_code = UART_PINS_ALREADY_IN_USE;
                                 send_err();
+                                break;
+                            }
+
+                            init_uart(&uart_state);
                         }
+                        send_ack();
                         break;
+                    default:
+                        last_error_code = GEN_UNKNOWN_MODE;
+                        send_err();
+                }
+                break;
 
-                    /*
-                     * I2C-SPECIFIC COMMANDS
-                     */
-                    case '1':   // SET BUS TO 100kHz
-                        set_i2c_frequency(&i2c_state, 100);
+            case 'x':   // RESET BUS
+                switch(current_mode) {
+                    case MODE_CODE_I2C:
+                        i2c_state->is_started = false;
+                        reset_i2c(i2c_state);
                         send_ack();
                         break;
-
-                    case '4':   // SET BUS TO 400kHZ
-                        set_i2c_frequency(&i2c_state, 400);
+                    case MODE_CODE_ONE_WIRE:
+                        ow_reset(&ow_state);
                         send_ack();
                         break;
-
-                    case 'p':   // SEND AN I2C STOP
-                        if (i2c_state.is_ready && i2c_state.is_started) {
-                            // Send no bytes and STOP
-                            uint8_t data = 0;
-                            i2c_write_timeout_us(i2c_state.bus, i2c_state.address, &data, 1, false, 1000);
-
-                            // Reset state
-                            i2c_state.is_started = false;
-                            i2c_state.is_read_op = false;
-                            send_ack();
-                        } else {
-                            last_error_code = I2C_ALREADY_STOPPED;
-                            send_err();
-                        }
+                    // FROM 1.3.0
+                    case MODE_CODE_SPI:
+                        if (spi_state.is_ready) reset_spi(&spi_state);
+                        send_ack();
+                        break;
+                    // FROM 1.3.0
+                    case MODE_CODE_UART:
+                        if (uart_state.is_ready) reset_uart(&uart_state);
+                        send_ack();
                         break;
+                    default:
+                        last_error_code = GEN_UNKNOWN_MODE;
+                        send_err();
+                }
+                break;
 
-                    case 's':   // START AN I2C TRANSACTION
-                        if (i2c_state.is_ready) {
-                            // Received data is in the form ['s', (address << 1) | op];
-                            i2c_state.address = (rx_buffer[1] & 0xFE) >> 1;
-                            i2c_state.is_read_op = ((rx_buffer[1] & 0x01) == 1);
-                            i2c_state.is_started = true;
-                            send_ack();
-                        } else {
-                            last_error_code = I2C_NOT_READY;
-                            send_err();
-                        }
+            // FROM 1.1.3
+            case 'k':   // DEINIT BUS
+                switch(current_mode) {
+                    case MODE_CODE_I2C:
+                        deinit_i2c(i2c_state);
+                        send_ack();
                         break;
+                    // FROM 1.3.0
+                    case MODE_CODE_SPI:
+                        deinit_spi(&spi_state);
+                        send_ack();
+                        break;
+                    case MODE_CODE_UART:
+                        deinit_uart(&uart_state);
+                        send_ack();
+                        break;
+                    default:
+                        last_error_code = GEN_UNKNOWN_MODE;
+                        send_err();
+                }
+                break;
+
+            /*
+             * I2C-SPECIFIC COMMANDS
+             */
+            // FROM 1.3.0
+            case I2C_BUS_CMD:   // SELECT THE I2C CONTROLLER LATER FRAMES USE
+                // NOTE Both controllers keep their own state, so one can be
+                //      mid-transaction while the other is used
+                if (current_mode == MODE_CODE_I2C) {
+                    i2c_state = &i2c_states[frame[1] & 0x01];
+                    send_ack();
+                } else {
+                    last_error_code = GEN_UNKNOWN_MODE;
+                    send_err();
+                }
+                break;
+
+            // FROM 1.3.0
+            case OW_SPEED_CMD:  // SET THE 1-WIRE BUS SPEED
+                // NOTE The ROM ID is always sent, but only used for
+                //      OW_SPEED_OVERDRIVE_MATCH
+                if (current_mode != MODE_CODE_ONE_WIRE) {
+                    last_error_code = GEN_UNKNOWN_MODE;
+                    send_err();
+                } else if (!ow_state.is_ready) {
+                    last_error_code = OW_NOT_READY;
+                    send_err();
+                } else if (frame[1] > OW_SPEED_OVERDRIVE_MATCH || !ow_set_speed(&ow_state, frame[1], &frame[2])) {
+                    last_error_code = OW_COULD_NOT_SET_SPEED;
+                    send_err();
+                } else {
+                    send_ack();
+                }
+                break;
 
-                    /*
-                     * ONE-WIRE COMMANDS
-                     */
+            // FROM 1.3.0
+            case OW_SEARCH_CMD: // SEARCH THE 1-WIRE BUS FOR ALARMING DEVICES OR A FAMILY
+                if (current_mode == MODE_CODE_ONE_WIRE) {
+                    ow_send_search(&ow_state, frame[1], frame[2]);
+                } else {
+                    last_error_code = GEN_UNKNOWN_MODE;
+                    send_err();
+                }
+                break;
+
+            // FROM 1.3.0
+            case OW_TEMPERATURES_CMD:   // CONVERT AND READ EVERY DS18B20 IN ONE GO
+                if (current_mode != MODE_CODE_ONE_WIRE) {
+                    last_error_code = GEN_UNKNOWN_MODE;
+                    send_err();
+                } else if (!ow_state.is_ready) {
+                    last_error_code = OW_NOT_READY;
+                    send_err();
+                } else if (!ow_send_temperatures(&ow_state, frame[1])) {
+                    last_error_code = OW_NO_DEVICES_FOUND;
+                    send_err();
+                }
+                break;
+
+            // FROM 1.3.0
+            case OW_TRIPLET_CMD:    // RUN ONE STEP OF A HOST-DRIVEN 1-WIRE SEARCH
+                // NOTE The host must first reset the bus and write the
+                //      search command
+                if (current_mode != MODE_CODE_ONE_WIRE) {
+                    last_error_code = GEN_UNKNOWN_MODE;
+                    send_err();
+                } else if (!ow_state.is_ready) {
+                    last_error_code = OW_NOT_READY;
+                    send_err();
+                } else {
+                    uint8_t result = ow_triplet(&ow_state, frame[1]);
+                    tx(&result, 1);
+                }
+                break;
+
+            case '1':   // SET BUS TO 100kHz
+                set_i2c_frequency(i2c_state, 100);
+                send_ack();
+                break;
+
+            case '4':   // SET BUS TO 400kHZ
+                set_i2c_frequency(i2c_state, 400);
+                send_ack();
+                break;
+
+            case 'p':   // SEND AN I2C STOP
+                // FROM 1.3.0 -- or release SPI chip select
+                if (current_mode == MODE_CODE_SPI) {
+                    if (spi_state.is_ready) select_spi(&spi_state, false);
+                    send_ack();
+                } else if (i2c_state->is_ready && i2c_state->is_started) {
+                    // Send no bytes and STOP
+                    uint8_t data = 0;
+                    i2c_write_timeout_us(i2c_state->bus, i2c_state->address, &data, 1, false, 1000);
+
+                    // Reset state
+                    i2c_state->is_started = false;
+                    i2c_state->is_read_op = false;
+                    send_ack();
+                } else {
+                    last_error_code = I2C_ALREADY_STOPPED;
+                    send_err();
+                }
+                break;
 
+            case 's':   // START AN I2C TRANSACTION
+                // FROM 1.3.0 -- or assert SPI chip select
+                if (current_mode == MODE_CODE_SPI) {
+                    if (spi_state.is_ready) {
+                        select_spi(&spi_state, true);
+                        send_ack();
+                    } else {
+                        last_error_code = SPI_NOT_STARTED;
+                        send_err();
+                    }
+                } else if (i2c_state->is_ready) {
+                    // Received data is in the form ['s', (address << 1) | op];
+                    i2c_state->address = (frame[1] & 0xFE) >> 1;
+                    i2c_state->is_read_op = ((frame[1] & 0x01) == 1);
+                    i2c_state->is_started = true;
+                    send_ack();
+                } else {
+                    last_error_code = I2C_NOT_READY;
+                    send_err();
+                }
+                break;
 
-                    // FROM 1.2.0
+            /*
+             * ONE-WIRE COMMANDS
+             */
 
-                    /*
-                     * GPIO COMMANDS
-                     */
 
-                    // FROM 1.1.0
-                    case 'g':   // SET DIGITAL OUT PIN
-                        {
-                            uint8_t read_value = 0;
-                            uint8_t gpio_pin = (rx_ptr[1] & 0x1F);
+            // FROM 1.2.0
 
-                            // Make sure the pin's not in use by a bus
-                            if (is_pin_taken(gpio_pin) > 1) {
-                                last_error_code = GPIO_PIN_ALREADY_IN_USE;
-                                send_err();
-                                break;
-                            }
+            /*
+             * GPIO COMMANDS
+             */
 
-                            // FROM 1.2.0
-                            // Clear the pin? Check for a postfix byte of the right value
-                            if (read_count > 2 && (rx_buffer[2] & 0x80)) {
-                                clear_pin(&gpio_state, gpio_pin);
-                                send_ack();
-                                break;
-                            }
+            // FROM 1.1.0
+            case 'g':   // SET DIGITAL OUT PIN
+                {
+                    uint8_t read_value = 0;
+                    uint8_t gpio_pin = (rx_ptr[1] & 0x1F);
 
-                            if (!set_gpio(&gpio_state, &read_value, rx_ptr)) {
-                                last_error_code = GPIO_CANT_SET_PIN;
-                                send_err();
-                                break;
-                            }
+                    // Make sure the pin's not in use by a bus
+                    if (is_pin_taken(gpio_pin) > 1) {
+                        last_error_code = GPIO_PIN_ALREADY_IN_USE;
+                        send_err();
+                        break;
+                    }
 
-                            bool is_read = ((rx_ptr[1] & 0x20) > 0);
-                            putchar(is_read ? read_value : ACK);
-                        }
+                    // FROM 1.2.0
+                    // Clear the pin? Check for a postfix byte of the right value
+                    if (read_count > 2 && frame[2] == GPIO_CLEAR_PIN_POSTFIX) {
+                        clear_pin(&gpio_state, gpio_pin);
+                        send_ack();
                         break;
+                    }
 
-                    default:    // UNKNOWN COMMAND -- FAIL
-                        last_error_code = GEN_UNKNOWN_COMMAND;
+                    if (!set_gpio(&gpio_state, &read_value, rx_ptr)) {
+                        last_error_code = GPIO_CANT_SET_PIN;
                         send_err();
+                        break;
+                    }
+
+                    bool is_read = ((rx_ptr[1] & 0x20) > 0);
+                    if (is_read) {
+                        tx(&read_value, 1);
+                    } else {
+                        send_ack();
+                    }
                 }
-            }
+                break;
 
-            // Clear buffer and listen for input
-            memset(rx_buffer, 0, read_count);
+            default:    // UNKNOWN COMMAND -- FAIL
+                last_error_code = GEN_UNKNOWN_COMMAND;
+                send_err();
         }
+    }
+}
 
-#ifdef SHOW_HEARTBEAT
-        // Heartbeat LED blink for debugging
-        if (do_use_led) {
-            uint64_t now = time_us_64();
-            if (now - last > HEARTBEAT_PERIOD_US) {
-                led_set_state(true);
-                is_on = true;
-                last = now;
-
-#ifdef DO_UART_DEBUG
-                debug_log("LED ON");
-#endif
-
-            } else if ((now - last > HEARTBEAT_FLASH_US) && is_on) {
-                led_set_state(false);
-                is_on = false;
-
-#ifdef DO_UART_DEBUG
-                debug_log("LED OFF");
-#endif
 
-            }
-        }
-#endif
+/**
+ * @brief Get the data length from an extended frame's header.
+ *        FROM 1.3.0
+ *
+ * @param frame: The frame: status byte then little-endian 16-bit length.
+ *
+ * @returns The length in bytes.
+ */
+static inline uint32_t extended_length(uint8_t* frame) {
 
-        // Pause? May not be necessary or might be bad
-        sleep_ms(RX_LOOP_DELAY_MS);
-    }
+    return (uint32_t)frame[1] | ((uint32_t)frame[2] << 8);
+}
 
-    // Should not get here, but just in case...
-    // Signal an error on the host's LED
-    led_set_colour(0xFF0000);
-    led_on();
 
-    // Fall out of the firmware at this point...
+/**
+ * @brief Record the board's identity, and use it to prepare the
+ *        fixed part of the binary status record.
+ *        FROM 1.3.0
+ */
+static void init_identity(void) {
+
+    int major = 0, minor = 0, patch = 0;
+    sscanf(FW_VERSION, "%i.%i.%i", &major, &minor, &patch);
+    board_identity.fw_major = (uint8_t)major;
+    board_identity.fw_minor = (uint8_t)minor;
+    board_identity.fw_patch = (uint8_t)patch;
+    board_identity.build_number = BUILD_NUM;
+
+    pico_unique_board_id_t board_id;
+    pico_get_unique_board_id(&board_id);
+    memcpy(board_identity.board_id, board_id.id, PICO_UNIQUE_BOARD_ID_SIZE_BYTES);
+    pico_get_unique_board_id_string(board_identity.board_id_string, sizeof(board_identity.board_id_string));
+
+    memset(board_identity.model, 0, sizeof(board_identity.model));
+    strncpy(board_identity.model, HW_MODEL, HW_MODEL_NAME_SIZE_MAX);
+
+    memset(&status_record, 0, sizeof(status_record));
+    status_record.record_version = STATUS_RECORD_VERSION;
+    status_record.fw_major = board_identity.fw_major;
+    status_record.fw_minor = board_identity.fw_minor;
+    status_record.fw_patch = board_identity.fw_patch;
+    status_record.build_number = board_identity.build_number;
+    memcpy(status_record.board_id, board_identity.board_id, PICO_UNIQUE_BOARD_ID_SIZE_BYTES);
+    memcpy(status_record.model, board_identity.model, HW_MODEL_NAME_SIZE_MAX);
+}
+
+
+/**
+ * @brief Get the board's cached identity.
+ *        FROM 1.3.0
+ *
+ * @returns A pointer to the identity record.
+ */
+BoardIdentity* get_board_identity(void) {
+
+    return &board_identity;
+}
+
+
+/**
+ * @brief Complete the binary status record for the current mode and send it.
+ *        FROM 1.3.0
+ */
+static void send_status_record(void) {
+
+    status_record.mode = current_mode;
+    status_record.last_error = (uint8_t)last_error_code;
+
+    switch(current_mode) {
+        case MODE_CODE_I2C:
+            status_record.flags = (i2c_state->is_ready ? STATUS_FLAG_READY : 0) | (i2c_state->is_started ? STATUS_FLAG_STARTED : 0);
+            status_record.bus = (i2c_state->bus == i2c0 ? 0 : 1);
+            status_record.pins[0] = i2c_state->sda_pin;
+            status_record.pins[1] = i2c_state->scl_pin;
+            status_record.address = i2c_state->address;
+            status_record.frequency_khz = (uint16_t)i2c_state->frequency;
+            status_record.device_count = 0;
+            break;
+        case MODE_CODE_ONE_WIRE:
+            status_record.flags = (ow_state.is_ready ? STATUS_FLAG_READY : 0) | (ow_state.is_overdrive ? STATUS_FLAG_OVERDRIVE : 0);
+            status_record.bus = 0;
+            status_record.pins[0] = ow_state.data_pin;
+            status_record.pins[1] = 0xFF;
+            status_record.address = 0xFF;
+            status_record.frequency_khz = 0;
+            status_record.device_count = (uint8_t)ow_state.device_count;
+            break;
+        case MODE_CODE_SPI:
+            status_record.flags = (spi_state.is_ready ? STATUS_FLAG_READY : 0) | (spi_state.is_selected ? STATUS_FLAG_STARTED : 0);
+            status_record.bus = (spi_state.bus == spi0 ? 0 : 1);
+            status_record.pins[0] = spi_state.sck_pin;
+            status_record.pins[1] = spi_state.tx_pin;
+            status_record.address = spi_state.cs_pin;
+            status_record.frequency_khz = (uint16_t)(spi_state.is_ready ? spi_state.actual_baud_khz : spi_state.baud_khz);
+            status_record.device_count = 0;
+            break;
+        case MODE_CODE_UART:
+            status_record.flags = (uart_state.is_ready ? STATUS_FLAG_READY : 0);
+            status_record.bus = (uart_state.bus == uart0 ? 0 : 1);
+            status_record.pins[0] = uart_state.tx_pin;
+            status_record.pins[1] = uart_state.rx_pin;
+            status_record.address = 0xFF;
+            status_record.frequency_khz = (uint16_t)((uart_state.is_ready ? uart_state.actual_baud : uart_state.baud) / 1000);
+            status_record.device_count = 0;
+            break;
+        default:
+            status_record.flags = 0;
+    }
+
+    tx((uint8_t*)&status_record, sizeof(status_record));
+}
+
+
+/**
+ * @brief Record a completed frame in the performance counters.
+ *        FROM 1.3.0
+ *
+ * @param status_byte: The frame's first byte.
+ * @param latency_us:  The time from the frame's arrival to its reply.
+ */
+static void count_frame(uint8_t status_byte, uint32_t latency_us) {
+
+    uint32_t slot = status_byte;
+    if (status_byte >= WRITE_LENGTH_BASE) {
+        slot = PERF_SLOT_WRITE;
+    } else if (status_byte >= READ_LENGTH_BASE) {
+        slot = PERF_SLOT_READ;
+    }
+
+    // Bucket 0 is 0us, bucket n is 2^(n-1) to 2^n - 1us
+    uint32_t bucket = latency_us == 0 ? 0 : 32 - __builtin_clz(latency_us);
+    if (bucket >= PERF_HISTOGRAM_BUCKETS) bucket = PERF_HISTOGRAM_BUCKETS - 1;
+
+    perf_counts[slot]++;
+    perf_latency[slot][bucket]++;
+}
+
+
+/**
+ * @brief Zero the performance counters, including the buses'.
+ *        FROM 1.3.0
+ */
+static void clear_counters(void) {
+
+    memset(perf_counts, 0, sizeof(perf_counts));
+    memset(perf_latency, 0, sizeof(perf_latency));
+    perf_rejected_frames = 0;
+    perf_cleared_us = time_us_64();
+    clear_i2c_counters(&i2c_states[0]);
+    clear_i2c_counters(&i2c_states[1]);
+    clear_spi_counters(&spi_state);
+    clear_uart_counters(&uart_state);
+    ow_clear_counters(&ow_state);
+}
+
+
+/**
+ * @brief Send the performance record: a PerfHeader, then a PerfSlot
+ *        for each command seen since the counters were cleared.
+ *        FROM 1.3.0
+ *
+ * @param flags: Command flags. `PERF_FLAG_RESET` clears the counters
+ *               once the record has been sent.
+ */
+static void send_counters(uint8_t flags) {
+
+    PerfHeader header;
+    memset(&header, 0, sizeof(header));
+    header.record_version = PERF_RECORD_VERSION;
+    header.bucket_count = PERF_HISTOGRAM_BUCKETS;
+    header.elapsed_ms = (uint32_t)((time_us_64() - perf_cleared_us) / 1000);
+    header.rejected_frames = perf_rejected_frames;
+    header.i2c_bytes_written = i2c_states[0].bytes_written_total + i2c_states[1].bytes_written_total;
+    header.i2c_bytes_read = i2c_states[0].bytes_read_total + i2c_states[1].bytes_read_total;
+    header.i2c_nak_count = i2c_states[0].nak_count + i2c_states[1].nak_count;
+    header.i2c_timeout_count = i2c_states[0].timeout_count + i2c_states[1].timeout_count;
+    header.ow_bytes_written = ow_state.bytes_written_total;
+    header.ow_bytes_read = ow_state.bytes_read_total;
+
+    for (uint32_t i = 0 ; i < PERF_COMMAND_SLOTS ; ++i) {
+        if (perf_counts[i] > 0) header.slot_count++;
+    }
+
+    tx((uint8_t*)&header, sizeof(header));
+
+    PerfSlot slot;
+    for (uint32_t i = 0 ; i < PERF_COMMAND_SLOTS ; ++i) {
+        if (perf_counts[i] == 0) continue;
+        if (i == PERF_SLOT_READ) {
+            slot.command = READ_LENGTH_BASE;
+        } else if (i == PERF_SLOT_WRITE) {
+            slot.command = WRITE_LENGTH_BASE;
+        } else {
+            slot.command = (uint8_t)i;
+        }
+
+        slot.count = perf_counts[i];
+        memcpy(slot.latency, perf_latency[i], sizeof(slot.latency));
+        tx((uint8_t*)&slot, sizeof(slot));
+    }
+
+    if (flags & PERF_FLAG_RESET) clear_counters();
+}
+
+
+/**
+ * @brief Add a completed frame to the command trace.
+ *        FROM 1.3.0
+ *
+ * @param frame:       The frame's bytes.
+ * @param length:      The frame's length in bytes; 0 for a rejected frame.
+ * @param sequence:    The frame's window sequence number, or NO_SEQUENCE.
+ * @param received_us: When core 0 received the frame, in microseconds.
+ * @param duration_us: The time from the frame's arrival to its reply.
+ */
+static void trace_frame(uint8_t* frame, uint32_t length, int sequence, uint32_t received_us, uint32_t duration_us) {
+
+    TraceRecord record;
+    record.received_us = received_us;
+    record.duration_us = duration_us;
+    record.length = (uint16_t)length;
+    record.command = length > 0 ? frame[0] : 0;
+    record.sequence = sequence == NO_SEQUENCE ? TRACE_NO_SEQUENCE : (uint8_t)sequence;
+    record.result = frame_result;
+    record.mode = current_mode;
+    record.reserved = 0;
+
+    switch(current_mode) {
+        case MODE_CODE_I2C:
+            record.bus_flags = (i2c_state->is_ready ? TRACE_BUS_FLAG_READY : 0) | (i2c_state->is_started ? TRACE_BUS_FLAG_STARTED : 0);
+            break;
+        case MODE_CODE_ONE_WIRE:
+            record.bus_flags = ow_state.is_ready ? TRACE_BUS_FLAG_READY : 0;
+            break;
+        case MODE_CODE_SPI:
+            record.bus_flags = (spi_state.is_ready ? TRACE_BUS_FLAG_READY : 0) | (spi_state.is_selected ? TRACE_BUS_FLAG_STARTED : 0);
+            break;
+        case MODE_CODE_UART:
+            record.bus_flags = uart_state.is_ready ? TRACE_BUS_FLAG_READY : 0;
+            break;
+        default:
+            record.bus_flags = 0;
+    }
+
+    trace_add(&record);
+}
+
+
+/**
+ * @brief Send the command trace: a TraceHeader, then the records,
+ *        oldest first. The dump command itself is added afterwards.
+ *        FROM 1.3.0
+ *
+ * @param flags: Command flags. `TRACE_FLAG_CLEAR` clears the trace
+ *               once it has been sent.
+ */
+static void send_trace(uint8_t flags) {
+
+    TraceHeader header;
+    header.record_version = TRACE_RECORD_VERSION;
+    header.record_size = sizeof(TraceRecord);
+    header.record_count = (uint16_t)trace_count();
+    header.dropped_count = trace_dropped();
+    header.now_us = (uint32_t)time_us_64();
+    tx((uint8_t*)&header, sizeof(header));
+
+    for (uint32_t i = 0 ; i < header.record_count ; ++i) {
+        tx((uint8_t*)trace_get(i), sizeof(TraceRecord));
+    }
+
+    if (flags & TRACE_FLAG_CLEAR) trace_clear();
+}
+
+
+/**
+ * @brief Start a sampling job, replacing any that's running: run a
+ *        transaction program every period, and stream each result to
+ *        the host as a SampleHeader plus the bytes read.
+ *        FROM 1.3.0
+ *
+ * @param data:   The 16-bit LE period in milliseconds, then the program.
+ * @param length: The data length in bytes.
+ */
+static void start_sampling(uint8_t* data, uint32_t length) {
+
+    uint32_t period_ms = (uint32_t)data[0] | ((uint32_t)data[1] << 8);
+    uint8_t* program = &data[SAMPLE_PERIOD_LENGTH_B];
+    length -= SAMPLE_PERIOD_LENGTH_B;
+
+    // Check the program is well formed before accepting it
+    if (period_ms == 0 || !is_program_valid(program, length)) {
+        last_error_code = GEN_BAD_PROGRAM;
+        send_err();
+        return;
+    }
+
+    if (sample_is_running) cancel_repeating_timer(&sample_timer);
+    memcpy(sample_program, program, length);
+    sample_program_length = length;
+    sample_sequence = 0;
+    sample_due = false;
+    sample_overrun = false;
+
+    // A negative period times each sample from the start of the last,
+    // so the job doesn't drift
+    sample_is_running = add_repeating_timer_ms(-(int32_t)period_ms, sample_timer_fired, NULL, &sample_timer);
+    if (sample_is_running) {
+        send_ack();
+    } else {
+        last_error_code = GEN_BAD_PROGRAM;
+        send_err();
+    }
+}
+
+
+/**
+ * @brief End the sampling job, if one is running, and send the host a
+ *        record flagged SAMPLE_FLAG_STOPPED to mark the end of the stream.
+ *        FROM 1.3.0
+ */
+static void stop_sampling(void) {
+
+    if (sample_is_running) {
+        cancel_repeating_timer(&sample_timer);
+        sample_is_running = false;
+    }
+
+    sample_due = false;
+    SampleHeader header;
+    memset(&header, 0, sizeof(header));
+    header.marker = SAMPLE_MARKER;
+    header.flags = SAMPLE_FLAG_STOPPED;
+    header.timestamp_us = (uint32_t)time_us_64();
+    header.sequence = sample_sequence;
+    tx((uint8_t*)&header, sizeof(header));
+}
+
+
+/**
+ * @brief Repeating timer callback, on core 0: flag a sample as due and
+ *        wake core 1 to take it.
+ *        FROM 1.3.0
+ *
+ * @param timer: The timer record.
+ *
+ * @returns `true` to keep the timer running.
+ */
+static bool sample_timer_fired(repeating_timer_t* timer) {
+
+    // Core 1 hasn't taken the last sample yet
+    if (sample_due) sample_overrun = true;
+
+    sample_due_us = (uint32_t)time_us_64();
+    sample_due = true;
+    __sev();
+    return true;
+}
+
+
+/**
+ * @brief Take a sample, if one is due, and send it to the host.
+ *        Called by the engine on core 1 between frames.
+ *        FROM 1.3.0
+ */
+static void run_sample_job(void) {
+
+    if (!sample_due || is_job_deferred(sample_program, sample_program_length)) return;
+    sample_due = false;
+    if (!sample_is_running) return;
+
+    SampleHeader header;
+    memset(&header, 0, sizeof(header));
+    header.marker = SAMPLE_MARKER;
+    header.timestamp_us = sample_due_us;
+    header.sequence = sample_sequence++;
+    if (sample_overrun) {
+        sample_overrun = false;
+        header.flags |= SAMPLE_FLAG_OVERRUN;
+    }
+
+    send_program_result(&header, sample_program, sample_program_length);
+}
+
+
+/**
+ * @brief Check a transaction program is well formed, without running it.
+ *        FROM 1.3.0
+ *
+ * @param program: The program's bytes.
+ * @param length:  The program's length in bytes.
+ *
+ * @returns Whether the program is good (`true`) or not (`false`).
+ */
+static bool is_program_valid(uint8_t* program, uint32_t length) {
+
+    uint32_t index = 0;
+    uint32_t op_count = 0;
+    uint8_t status;
+    while (index < length) {
+        if (op_count++ == PROGRAM_OPS_MAX || !run_program_op(program, length, &index, NULL, &status)) return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Should a job wait? Jobs also run while a frame waits for an I2C
+ *        DMA transfer, so one whose program uses I2C is held until the
+ *        transfer ends. Its time was taken when it fell due, so only its
+ *        reply is later. Other ops can't read anything in I2C mode, so
+ *        the rest can't disturb the frame's data.
+ *        FROM 1.3.0
+ *
+ * @param program: The job's program.
+ * @param length:  The program's length in bytes.
+ *
+ * @returns Whether to hold the job (`true`) or run it (`false`).
+ */
+static bool is_job_deferred(uint8_t* program, uint32_t length) {
+
+    if (!is_i2c_busy(i2c_state)) return false;
+
+    uint32_t index = 0;
+    uint8_t status;
+    while (index < length) {
+        uint8_t op = program[index];
+        if (op == PROGRAM_OP_I2C_WRITE || op == PROGRAM_OP_I2C_READ || op == PROGRAM_OP_I2C_STOP) return true;
+        if (!run_program_op(program, length, &index, NULL, &status)) break;
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Run a sampling job's or trigger's program, and stream the
+ *        outcome to the host: the completed header, then the bytes read.
+ *        FROM 1.3.0
+ *
+ * @param header:  The record header, with all but the outcome set.
+ * @param program: The program's bytes.
+ * @param length:  The program's length in bytes.
+ */
+static void send_program_result(SampleHeader* header, uint8_t* program, uint32_t length) {
+
+    uint8_t status[PROGRAM_OPS_MAX];
+    uint32_t op_count = 0;
+    uint32_t read_count = 0;
+    execute_program(program, length, status, &op_count, &read_count);
+    for (uint32_t i = 0 ; i < op_count ; ++i) {
+        if (status[i] != GEN_NO_ERROR && status[i] != PROGRAM_OP_SKIPPED) {
+            header->flags |= SAMPLE_FLAG_ERROR;
+            header->error = status[i];
+            read_count = 0;
+            break;
+        }
+    }
+
+    // Go out straight away, with any replies already queued
+    header->length = (uint16_t)read_count;
+    tx_queue((uint8_t*)header, sizeof(SampleHeader));
+    if (read_count > 0) tx_queue(bus_rx_buffer, read_count);
+    tx_flush();
+}
+
+
+/**
+ * @brief Arm or disarm a pin trigger: run a transaction program on each
+ *        of the pin's chosen edges, and stream each result to the host
+ *        as a SampleHeader, flagged SAMPLE_FLAG_TRIGGER, plus the bytes
+ *        read. The header's timestamp is the time of the edge.
+ *        FROM 1.3.0
+ *
+ *        Arming replies with ACK or ERR. Disarming replies with a record
+ *        flagged SAMPLE_FLAG_TRIGGER | SAMPLE_FLAG_STOPPED, to mark the
+ *        end of the pin's records.
+ *
+ * @param data:   The pin, then for arming the edges and the program.
+ *                GPIO_TRIGGER_ALL_PINS disarms every trigger.
+ * @param length: The data length in bytes: 1 to disarm.
+ */
+static void set_trigger(uint8_t* data, uint32_t length) {
+
+    uint8_t pin = data[0];
+    if (length == 1) {
+        disarm_trigger(&gpio_state, pin);
+        SampleHeader header;
+        memset(&header, 0, sizeof(header));
+        header.marker = SAMPLE_MARKER;
+        header.flags = SAMPLE_FLAG_TRIGGER | SAMPLE_FLAG_STOPPED;
+        header.pin = pin;
+        header.timestamp_us = (uint32_t)time_us_64();
+        tx((uint8_t*)&header, sizeof(header));
+        return;
+    }
+
+    uint8_t* program = &data[TRIGGER_HEADER_LENGTH_B];
+    length -= TRIGGER_HEADER_LENGTH_B;
+    if (!is_program_valid(program, length)) {
+        last_error_code = GEN_BAD_PROGRAM;
+        send_err();
+        return;
+    }
+
+    // Make sure the pin's not in use by a bus
+    if (pin <= GPIO_PIN_MAX && (is_pin_taken(pin) & ~PIN_USAGE_FIELD_GPIO) > 0) {
+        last_error_code = GPIO_PIN_ALREADY_IN_USE;
+        send_err();
+        return;
+    }
+
+    uint8_t result = arm_trigger(&gpio_state, pin, data[1], program, length);
+    if (result == GEN_NO_ERROR) {
+        send_ack();
+    } else {
+        last_error_code = result;
+        send_err();
+    }
+}
+
+
+/**
+ * @brief Run the programs of any pin triggers that have fired, and send
+ *        the results to the host. Called by the engine on core 1.
+ *        FROM 1.3.0
+ */
+static void run_triggers(void) {
+
+    uint64_t edge_us;
+    bool is_overrun;
+    for (uint32_t i = 0 ; i < GPIO_TRIGGER_MAX ; ++i) {
+        GPIO_Trigger* trigger = &gpio_state.triggers[i];
+        if (is_job_deferred(trigger->program, trigger->program_length)) continue;
+        if (!take_trigger(&gpio_state, i, &edge_us, &is_overrun)) continue;
+
+        SampleHeader header;
+        memset(&header, 0, sizeof(header));
+        header.marker = SAMPLE_MARKER;
+        header.flags = SAMPLE_FLAG_TRIGGER | (is_overrun ? SAMPLE_FLAG_OVERRUN : 0);
+        header.pin = trigger->pin;
+        header.timestamp_us = (uint32_t)edge_us;
+        header.sequence = trigger->sequence++;
+        send_program_result(&header, trigger->program, trigger->program_length);
+    }
+}
+
+
+/**
+ * @brief The engine's tick handler: run any timed or triggered work
+ *        that's due. Core 1 only.
+ *        FROM 1.3.0
+ */
+static void run_jobs(void) {
+
+    run_triggers();
+    run_sample_job();
+}
+
+
+/**
+ * @brief Unwrap a windowed frame and pass it to core 1.
+ *        FROM 1.3.0
+ *
+ * @param frame:      The frame: '>', sequence number, 16-bit LE length, inner frame.
+ * @param read_count: The frame's length in bytes.
+ */
+static void queue_frame(uint8_t* frame, uint32_t read_count) {
+
+    uint32_t inner_length = extended_length(&frame[1]);
+    if (read_count != WINDOW_HEADER_LENGTH_B + inner_length || inner_length == 0 || frame[WINDOW_HEADER_LENGTH_B] == WINDOW_FRAME_CMD) {
+        // Bad length or a nested window frame
+        engine_reject(frame[1], GEN_BAD_FRAME_LENGTH);
+        return;
+    }
+
+    engine_submit(&frame[WINDOW_HEADER_LENGTH_B], inner_length, frame[1]);
+}
+
+
+/**
+ * @brief Run a frame passed from core 0. Core 1 only.
+ *        FROM 1.3.0
+ *
+ * @param frame:       The frame's bytes.
+ * @param length:      The frame's length in bytes.
+ * @param sequence:    The frame's window sequence number, or NO_SEQUENCE.
+ * @param error_code:  If non-zero, core 0 rejected the frame: report this error.
+ * @param received_us: When core 0 received the frame, in microseconds.
+ * @param more_queued: Whether more frames are waiting.
+ */
+static void run_frame(uint8_t* frame, uint32_t length, int sequence, uint8_t error_code, uint32_t received_us, bool more_queued) {
+
+    reply_sequence = sequence;
+    frame_result = GEN_NO_ERROR;
+    if (error_code != GEN_NO_ERROR) {
+        last_error_code = error_code;
+        send_err();
+    } else {
+        process_frame(frame, length);
+    }
+
+    reply_sequence = NO_SEQUENCE;
+
+    // Windowed replies are batched until the queue empties
+    if (!more_queued) tx_flush();
+
+    // FROM 1.3.0
+    // Time the frame from its arrival to its reply being handed to core 0
+    uint32_t duration_us = (uint32_t)time_us_64() - received_us;
+    if (error_code != GEN_NO_ERROR) {
+        perf_rejected_frames++;
+    } else {
+        count_frame(frame[0], duration_us);
+    }
+
+    trace_frame(frame, length, sequence, received_us, duration_us);
+}
+
+
+/**
+ * @brief Run a transaction program: a list of bus primitives executed
+ *        back to back, replying once with the outcome of each and any
+ *        data read.
+ *        FROM 1.3.0
+ *
+ *        Reply: op count, one status byte per op (an error code, or
+ *        GEN_NO_ERROR), then the bytes read by the successful read ops,
+ *        in order. Ops after a failure are not run and report
+ *        PROGRAM_OP_SKIPPED. A malformed program gets ERR.
+ *
+ * @param program: The program's bytes.
+ * @param length:  The program's length in bytes.
+ */
+static void run_program(uint8_t* program, uint32_t length) {
+
+    uint8_t status[PROGRAM_OPS_MAX + 1];
+    uint32_t op_count = 0;
+    uint32_t read_count = 0;
+
+    if (!execute_program(program, length, &status[1], &op_count, &read_count)) {
+        last_error_code = GEN_BAD_PROGRAM;
+        send_err();
+        return;
+    }
+
+    for (uint32_t i = 1 ; i <= op_count ; ++i) {
+        if (status[i] != GEN_NO_ERROR && status[i] != PROGRAM_OP_SKIPPED) {
+            last_error_code = status[i];
+            break;
+        }
+    }
+
+    status[0] = (uint8_t)op_count;
+    tx_queue(status, 1 + op_count);
+    if (read_count > 0) tx_queue(bus_rx_buffer, read_count);
+    tx_flush();
+}
+
+
+/**
+ * @brief Run a transaction program's ops, recording each one's outcome.
+ *        Data read by the program is placed in `bus_rx_buffer`.
+ *        FROM 1.3.0
+ *
+ * @param program:    The program's bytes.
+ * @param length:     The program's length in bytes.
+ * @param status:     Space for PROGRAM_OPS_MAX op outcomes.
+ * @param op_count:   Set to the number of ops.
+ * @param read_count: Set to the number of bytes read.
+ *
+ * @returns `false` if the program is malformed, otherwise `true`.
+ */
+static bool execute_program(uint8_t* program, uint32_t length, uint8_t* status, uint32_t* op_count, uint32_t* read_count) {
+
+    uint32_t index = 0;
+    bool failed = false;
+    *op_count = 0;
+    *read_count = 0;
+
+    while (index < length) {
+        if (*op_count == PROGRAM_OPS_MAX) return false;
+
+        if (failed) {
+            // Just step over the op
+            uint8_t skip_status;
+            if (!run_program_op(program, length, &index, NULL, &skip_status)) return false;
+            status[(*op_count)++] = PROGRAM_OP_SKIPPED;
+            continue;
+        }
+
+        if (!run_program_op(program, length, &index, read_count, &status[*op_count])) return false;
+        if (status[*op_count] != GEN_NO_ERROR) failed = true;
+        (*op_count)++;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Decode, and optionally run, one op from a transaction program.
+ *        FROM 1.3.0
+ *
+ * @param program:    The program's bytes.
+ * @param length:     The program's length in bytes.
+ * @param index:      The op's index in the program; updated to the next op.
+ * @param read_count: The number of bytes read so far, or NULL to decode the
+ *                    op without running it.
+ * @param status:     Set to the op's outcome.
+ *
+ * @returns `false` if the op is malformed, otherwise `true`.
+ */
+static bool run_program_op(uint8_t* program, uint32_t length, uint32_t* index, uint32_t* read_count, uint8_t* status) {
+
+    uint32_t i = *index;
+    uint8_t op = program[i++];
+    uint8_t address = 0;
+    uint32_t byte_count = 0;
+    bool do_run = (read_count != NULL);
+    *status = GEN_NO_ERROR;
+
+    // Get the op's arguments
+    switch(op) {
+        case PROGRAM_OP_I2C_WRITE:
+        case PROGRAM_OP_I2C_READ:
+            if (i >= length) return false;
+            address = program[i++];
+            // Fall through
+        case PROGRAM_OP_OW_WRITE:
+        case PROGRAM_OP_OW_READ:
+        case PROGRAM_OP_OW_READ_CRC8:
+        case PROGRAM_OP_OW_READ_CRC16:
+        case PROGRAM_OP_DELAY:
+            if (i + 2 > length) return false;
+            byte_count = (uint32_t)program[i] | ((uint32_t)program[i + 1] << 8);
+            i += 2;
+            break;
+        case PROGRAM_OP_I2C_STOP:
+        case PROGRAM_OP_OW_RESET:
+            break;
+        default:
+            return false;
+    }
+
+    // Check data fits
+    if (op == PROGRAM_OP_I2C_WRITE || op == PROGRAM_OP_OW_WRITE) {
+        if (byte_count == 0 || i + byte_count > length) return false;
+    }
+
+    if ((op == PROGRAM_OP_I2C_READ || op == PROGRAM_OP_OW_READ) && byte_count == 0) return false;
+    // FROM 1.3.0 -- checked reads must have room for data and the CRC
+    if (op == PROGRAM_OP_OW_READ_CRC8 && byte_count < 2) return false;
+    if (op == PROGRAM_OP_OW_READ_CRC16 && byte_count < 3) return false;
+
+    *index = (op == PROGRAM_OP_I2C_WRITE || op == PROGRAM_OP_OW_WRITE) ? i + byte_count : i;
+    if (!do_run) return true;
+
+    // Run the op
+    switch(op) {
+        case PROGRAM_OP_I2C_WRITE:
+        case PROGRAM_OP_I2C_READ:
+            if (current_mode != MODE_CODE_I2C || !i2c_state->is_ready) {
+                *status = I2C_NOT_READY;
+                break;
+            }
+
+            {
+                // Hold the bus unless the next op is a STOP
+                bool nostop = !(*index < length && program[*index] == PROGRAM_OP_I2C_STOP);
+                int result;
+                if (op == PROGRAM_OP_I2C_WRITE) {
+                    result = write_i2c(i2c_state, address, &program[i], byte_count, nostop, I2C_TRANSFER_TIMEOUT_US(byte_count));
+                    count_i2c_transfer(i2c_state, result, false);
+                    if (result == PICO_ERROR_GENERIC || result == PICO_ERROR_TIMEOUT) *status = I2C_COULD_NOT_WRITE;
+                } else {
+                    if (*read_count + byte_count > EXTENDED_FRAME_MAX_B) {
+                        *status = GEN_BAD_PROGRAM;
+                        break;
+                    }
+
+                    result = read_i2c(i2c_state, address, &bus_rx_buffer[*read_count], byte_count, nostop, I2C_TRANSFER_TIMEOUT_US(byte_count));
+                    count_i2c_transfer(i2c_state, result, true);
+                    if (result == PICO_ERROR_GENERIC || result == PICO_ERROR_TIMEOUT) {
+                        *status = I2C_COULD_NOT_READ;
+                    } else {
+                        *read_count += byte_count;
+                    }
+                }
+            }
+            break;
+        case PROGRAM_OP_I2C_STOP:
+            // Applied by the preceding op
+            if (current_mode != MODE_CODE_I2C) *status = GEN_UNKNOWN_MODE;
+            break;
+        case PROGRAM_OP_OW_RESET:
+        case PROGRAM_OP_OW_WRITE:
+        case PROGRAM_OP_OW_READ:
+        case PROGRAM_OP_OW_READ_CRC8:
+        case PROGRAM_OP_OW_READ_CRC16:
+            if (current_mode != MODE_CODE_ONE_WIRE || !ow_state.is_ready) {
+                *status = OW_NOT_READY;
+                break;
+            }
+
+            if (op == PROGRAM_OP_OW_RESET) {
+                if (!ow_reset(&ow_state)) *status = OW_NO_DEVICES_FOUND;
+            } else if (op == PROGRAM_OP_OW_WRITE) {
+                ow_write_bytes(&ow_state, &program[i], byte_count);
+            } else {
+                if (*read_count + byte_count > EXTENDED_FRAME_MAX_B) {
+                    *status = GEN_BAD_PROGRAM;
+                    break;
+                }
+
+                ow_read_bytes(&ow_state, &bus_rx_buffer[*read_count], byte_count);
+
+                // FROM 1.3.0 -- data that fails its CRC is not returned,
+                //               and the rest of the program is skipped
+                if (op != PROGRAM_OP_OW_READ && !ow_check_crc(&bus_rx_buffer[*read_count], byte_count, op == PROGRAM_OP_OW_READ_CRC8 ? OW_CRC_8 : OW_CRC_16)) {
+                    *status = OW_CRC_ERROR;
+                    break;
+                }
+
+                *read_count += byte_count;
+            }
+            break;
+        case PROGRAM_OP_DELAY:
+            sleep_us(byte_count);
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Write data received from the host out to the current bus,
+ *        and ACK or ERR the host accordingly.
+ *        FROM 1.3.0 -- shared by standard and extended write frames.
+ *
+ * @param data:       A pointer to the bytes to write.
+ * @param byte_count: The number of bytes to write.
+ */
+static void write_bus_data(uint8_t* data, uint32_t byte_count) {
+
+    switch(current_mode){
+        case MODE_CODE_I2C:
+            if (i2c_state->is_started) {
+                i2c_state->write_byte_count = byte_count;
+#ifdef DO_UART_DEBUG
+                debug_log("Bytes to write: %i", i2c_state->write_byte_count);
+#endif
+                int bytes_sent = write_i2c(i2c_state, i2c_state->address, data, i2c_state->write_byte_count, false, I2C_TRANSFER_TIMEOUT_US(byte_count));
+                count_i2c_transfer(i2c_state, bytes_sent, false);
+#ifdef DO_UART_DEBUG
+                debug_log("Bytes sent: %i", bytes_sent);
+#endif
+                // Send an ACK to say we wrote the data -- or an ERR if we didn't
+                if (bytes_sent != PICO_ERROR_GENERIC && bytes_sent != PICO_ERROR_TIMEOUT) {
+                    send_ack();
+                    break;
+                }
+            }
+
+            // Error
+            last_error_code = I2C_COULD_NOT_WRITE;
+            send_err();
+            break;
+        case MODE_CODE_ONE_WIRE:
+            if (ow_state.is_ready) {
+                ow_state.write_byte_count = byte_count;
+#ifdef DO_UART_DEBUG
+                debug_log("Bytes to write: %i", ow_state.write_byte_count);
+#endif
+                // FROM 1.3.0 -- pipelined through the PIO engine
+                ow_write_bytes(&ow_state, data, ow_state.write_byte_count);
+
+                send_ack();
+            } else {
+                last_error_code = OW_NOT_READY;
+                send_err();
+            }
+            break;
+        // FROM 1.3.0
+        case MODE_CODE_SPI:
+            if (spi_state.is_ready) {
+                transfer_spi(&spi_state, data, NULL, byte_count);
+                send_ack();
+            } else {
+                last_error_code = SPI_NOT_STARTED;
+                send_err();
+            }
+            break;
+        // FROM 1.3.0
+        // NOTE The ACK says the data is queued, not sent
+        case MODE_CODE_UART:
+            if (uart_state.is_ready) {
+                write_uart(&uart_state, data, byte_count);
+                send_ack();
+            } else {
+                last_error_code = UART_NOT_STARTED;
+                send_err();
+            }
+            break;
+        default:
+            last_error_code = GEN_UNKNOWN_MODE;
+            send_err();
+    }
+}
+
+
+/**
+ * @brief Read data from the current bus and send it to the host.
+ *        FROM 1.3.0 -- shared by standard and extended read frames.
+ *
+ * @param byte_count: The number of bytes to read.
+ */
+static void read_bus_data(uint32_t byte_count) {
+
+    switch(current_mode){
+        case MODE_CODE_I2C:
+            if (i2c_state->is_started) {
+                i2c_state->read_byte_count = byte_count;
+
+                int bytes_read = read_i2c(i2c_state, i2c_state->address, bus_rx_buffer, i2c_state->read_byte_count, false, I2C_TRANSFER_TIMEOUT_US(byte_count));
+                count_i2c_transfer(i2c_state, bytes_read, true);
+
+                // Return the read data
+                if (bytes_read != PICO_ERROR_GENERIC && bytes_read != PICO_ERROR_TIMEOUT) {
+                    tx(bus_rx_buffer, i2c_state->read_byte_count);
+                    break;
+                }
+            }
+            last_error_code = I2C_COULD_NOT_READ;
+            frame_result = I2C_COULD_NOT_READ;
+            break;
+        case MODE_CODE_ONE_WIRE:
+            if (ow_state.is_ready) {
+                ow_state.read_byte_count = byte_count;
+
+                // FROM 1.3.0 -- pipelined through the PIO engine
+                ow_read_bytes(&ow_state, bus_rx_buffer, ow_state.read_byte_count);
+
+                tx(bus_rx_buffer, ow_state.read_byte_count);
+            }
+            break;
+        // FROM 1.3.0
+        case MODE_CODE_SPI:
+            if (spi_state.is_ready) {
+                transfer_spi(&spi_state, NULL, bus_rx_buffer, byte_count);
+                tx(bus_rx_buffer, byte_count);
+            } else {
+                last_error_code = SPI_NOT_STARTED;
+                send_err();
+            }
+            break;
+        default:
+            last_error_code = GEN_UNKNOWN_MODE;
+            send_err();
+    }
+}
+
+
+/**
+ * @brief Clock data out to the SPI bus while reading the same number
+ *        of bytes in, and send the bytes read to the host.
+ *        FROM 1.3.0
+ *
+ * @param data:       A pointer to the bytes to write.
+ * @param byte_count: The number of bytes to transfer.
+ */
+static void transfer_bus_data(uint8_t* data, uint32_t byte_count) {
+
+    if (current_mode != MODE_CODE_SPI) {
+        last_error_code = GEN_UNKNOWN_MODE;
+        send_err();
+    } else if (!spi_state.is_ready) {
+        last_error_code = SPI_NOT_STARTED;
+        send_err();
+    } else {
+        transfer_spi(&spi_state, data, bus_rx_buffer, byte_count);
+        tx(bus_rx_buffer, byte_count);
+    }
 }
 
 
@@ -537,7 +1915,15 @@ static inline void send_ack(void) {
 #ifdef BUILD_FOR_TERMINAL_TESTING
     printf("ACK\r\n");
 #else
-    putchar(ACK);
+    // FROM 1.3.0 -- replies to windowed frames carry the sequence number,
+    //               and go out with the rest of the window's replies
+    if (reply_sequence != NO_SEQUENCE) {
+        uint8_t ack[2] = {ACK, (uint8_t)reply_sequence};
+        tx_queue(ack, 2);
+    } else {
+        uint8_t ack = ACK;
+        tx(&ack, 1);
+    }
 #ifdef DO_UART_DEBUG
     debug_log("********** ACK **********");
 #endif
@@ -552,50 +1938,298 @@ static inline void send_err(void) {
 #ifdef BUILD_FOR_TERMINAL_TESTING
     printf("ERR\r\n");
 #else
-    putchar(ERR);
+    // FROM 1.3.0 -- note the failure for the trace
+    frame_result = (uint8_t)last_error_code;
+    if (reply_sequence != NO_SEQUENCE) {
+        uint8_t err[2] = {ERR, (uint8_t)reply_sequence};
+        tx_queue(err, 2);
+    } else {
+        uint8_t err = ERR;
+        tx(&err, 1);
+    }
 #endif
 }
 
 
 /**
- * @brief Read in a single transmitted block.
+ * @brief Read in a single transmitted frame.
  *
- * @param buffer: A pointer to the byte store buffer.
+ *        FROM 1.3.0 -- the frame's length is determined from its first
+ *        (status) byte, and exactly that many bytes are read, rather than
+ *        reading byte by byte until the host goes quiet.
+ *
+ * @param buffer:      A pointer to the byte store buffer.
+ * @param mode:        The current bus mode, which sets some commands' lengths.
+ * @param is_complete: Pointer to a bool set `false` if the frame was truncated.
  *
  * @returns The number of bytes to process.
  */
-static uint32_t rx(uint8_t* buffer) {
+static uint32_t rx(uint8_t* buffer, char mode, bool* is_complete) {
+
+    *is_complete = true;
+
+    // Anything waiting?
+    int c = rx_byte(SERIAL_READ_TIMEOUT_US);
+    if (c == PICO_ERROR_TIMEOUT) return 0;
+    buffer[0] = (uint8_t)c;
+
+    // Get the rest of the frame. Its bytes will arrive in the same or
+    // the next USB packet, so allow for a packet interval between them
+    uint32_t expected_byte_count = frame_length(buffer[0], mode);
+    uint32_t buffer_byte_count = 1;
+    while (buffer_byte_count < expected_byte_count) {
+        c = rx_byte(FRAME_BYTE_TIMEOUT_US);
+        if (c == PICO_ERROR_TIMEOUT) {
+            *is_complete = false;
+            break;
+        }
 
-    uint32_t buffer_byte_count = 0;
-    int c = PICO_ERROR_TIMEOUT;
-    while (buffer_byte_count < RX_BUFFER_LENGTH_B) {
-        c = getchar_timeout_us(1);
-        if (c == PICO_ERROR_TIMEOUT) break;
         buffer[buffer_byte_count++] = (uint8_t)c;
-        sleep_ms(UART_LOOP_DELAY_MS);
+
+        // Extended write frames give their data length in the header
+        if ((buffer[0] == 'W' || buffer[0] == PROGRAM_CMD || buffer[0] == SAMPLE_CMD || buffer[0] == TRIGGER_CMD || buffer[0] == SPI_TRANSFER_CMD) && buffer_byte_count == EXTENDED_HEADER_LENGTH_B) {
+            uint32_t data_length = extended_length(buffer);
+            // A zero length is only good for SAMPLE_CMD: it stops the job
+            if ((data_length == 0 && buffer[0] != SAMPLE_CMD) || data_length > EXTENDED_FRAME_MAX_B) {
+                // Bad length: step over the payload the host sent with it,
+                // so the next frame starts cleanly, and reject this one
+                rx_skip(data_length < EXTENDED_FRAME_MAX_B ? data_length : EXTENDED_FRAME_MAX_B);
+                *is_complete = false;
+                break;
+            }
+            expected_byte_count += data_length;
+        }
+
+        // So do windowed frames
+        if (buffer[0] == WINDOW_FRAME_CMD && buffer_byte_count == WINDOW_HEADER_LENGTH_B) {
+            uint32_t data_length = extended_length(&buffer[1]);
+            if (data_length == 0 || data_length > WINDOW_FRAME_MAX_B) {
+                // Bad length: step over the payload, but pass on the header
+                // so `queue_frame()` rejects the frame by its sequence number
+                rx_skip(data_length < WINDOW_FRAME_MAX_B ? data_length : WINDOW_FRAME_MAX_B);
+                break;
+            }
+            expected_byte_count += data_length;
+        }
+    }
+
+    if (*is_complete) {
+        if (buffer[0] == 'g') {
+            // GPIO frames may carry an optional 'clear pin' postfix byte
+            // (0xF0), sent in the same write as the rest of the frame.
+            // Anything else is the start of the next frame, so keep it
+            c = rx_byte(SERIAL_READ_TIMEOUT_US);
+            if (c != PICO_ERROR_TIMEOUT) {
+                if (c == GPIO_CLEAR_PIN_POSTFIX) {
+                    buffer[buffer_byte_count++] = (uint8_t)c;
+                } else {
+                    rx_lookahead = c;
+                }
+            }
+        } else if (expected_byte_count == 0) {
+            // Unknown command: we don't know its length, so take whatever
+            // else the host sent with it to resynchronise on the next frame
+            while (buffer_byte_count < RX_BUFFER_LENGTH_B) {
+                c = rx_byte(0);
+                if (c == PICO_ERROR_TIMEOUT) break;
+                buffer[buffer_byte_count++] = (uint8_t)c;
+            }
+        }
     }
 
 #ifdef DO_UART_DEBUG
-    if (buffer_byte_count > 0) debug_log("Bytes received: %i", buffer_byte_count);
+    debug_log("Bytes received: %i", buffer_byte_count);
 #endif
     return buffer_byte_count;
 }
 
 
+/**
+ * @brief Read a single byte from the host.
+ *        FROM 1.3.0
+ *
+ * @param timeout_us: How long to wait for a byte.
+ *
+ * @returns The byte value, or `PICO_ERROR_TIMEOUT`.
+ */
+static int rx_byte(uint32_t timeout_us) {
+
+    if (rx_lookahead != PICO_ERROR_TIMEOUT) {
+        int c = rx_lookahead;
+        rx_lookahead = PICO_ERROR_TIMEOUT;
+        return c;
+    }
+
+    return transport_get_byte(timeout_us);
+}
+
+
+/**
+ * @brief Discard bytes from the host, eg. the payload of a bad frame.
+ *        FROM 1.3.0
+ *
+ * @param byte_count: The number of bytes to discard. Stops early if the
+ *                    host goes quiet.
+ */
+static void rx_skip(uint32_t byte_count) {
+
+    while (byte_count-- > 0) {
+        if (rx_byte(FRAME_BYTE_TIMEOUT_US) == PICO_ERROR_TIMEOUT) break;
+    }
+}
+
+
+/**
+ * @brief Calculate the full length of a frame from its status byte.
+ *        FROM 1.3.0
+ *
+ * @param status_byte: The frame's first byte.
+ * @param mode:        The current bus mode.
+ *
+ * @returns The frame length in bytes, or 0 for an unknown command.
+ */
+static uint32_t frame_length(uint8_t status_byte, char mode) {
+
+    // Write data: the status byte plus 1-64 bytes
+    if (status_byte >= WRITE_LENGTH_BASE) return status_byte - WRITE_LENGTH_BASE + 2;
+
+    // Read op: the status byte only
+    if (status_byte >= READ_LENGTH_BASE) return 1;
+
+    switch((char)status_byte) {
+        case 'z':
+        case '!':
+        case '?':
+        case STATUS_CMD:
+        case '$':
+        case 'd':
+        case 'D':
+        case 'i':
+        case 'x':
+        case 'k':
+        case '1':
+        case '4':
+        case 'p':
+            return 1;
+        case '*':
+        case '#':
+        case PERF_CMD:
+        case TRACE_CMD:
+        case I2C_BUS_CMD:
+        case OW_TRIPLET_CMD:
+        case OW_TEMPERATURES_CMD:
+        case 's':
+        case 'g':   // Plus an optional postfix byte
+            return 2;
+        case 'W':   // Plus the data, whose length is in the header
+        case 'R':
+        case UART_READ_CMD:
+        case PROGRAM_CMD:
+        case SAMPLE_CMD:
+        case TRIGGER_CMD:
+        case SPI_TRANSFER_CMD:
+            return EXTENDED_HEADER_LENGTH_B;
+        case WINDOW_FRAME_CMD:
+            return WINDOW_HEADER_LENGTH_B;
+        case 'E':   // 'E', first address, last address, 16-bit timeout, flags
+            return 6;
+        case OW_SPEED_CMD:  // 'o', speed, 8-byte ROM ID
+            return 10;
+        case OW_SEARCH_CMD: // 'S', flags, family code
+            return 3;
+        case 'c':
+            // Bus config data varies with bus type
+            switch(mode) {
+                case MODE_CODE_I2C:
+                    return 4;       // 'c', bus ID, SDA pin, SCL pin
+                case MODE_CODE_ONE_WIRE:
+                    return 2;       // 'c', data pin
+                case MODE_CODE_SPI:
+                    return 9;       // 'c', bus ID, SCK, TX, RX and CS pins, mode, 16-bit clock (kHz)
+                case MODE_CODE_UART:
+                    return 11;      // 'c', bus ID, TX and RX pins, 32-bit baud, data bits, stop bits, parity
+                default:
+                    return 1;
+            }
+        default:
+            return 0;
+    }
+}
+
+
 /**
  * @brief Send a single transmitted block.
  *
+ *        FROM 1.3.0 -- this is a convenience function that queues
+ *        the data and then immediately flushes it.
+ *
  * @param buffer:     A pointer to the byte store buffer.
  * @param byte_count: The number of bytes to send.
  */
 void tx(uint8_t* buffer, uint32_t byte_count) {
 
-    for (uint32_t i = 0 ; i < byte_count ; ++i) {
-        putchar((buffer[i]));
-        sleep_ms(UART_LOOP_DELAY_MS);
+    tx_queue(buffer, byte_count);
+    tx_flush();
+}
+
+
+/**
+ * @brief Add data to the outgoing response. Full packets are
+ *        passed to core 0 as they are completed. Core 1 only.
+ *        FROM 1.3.0
+ *
+ * @param buffer:     A pointer to the byte store buffer.
+ * @param byte_count: The number of bytes to send.
+ */
+void tx_queue(uint8_t* buffer, uint32_t byte_count) {
+
+    while (byte_count > 0) {
+        uint32_t space = TX_BUFFER_LENGTH_B - tx_byte_count;
+        uint32_t length = byte_count < space ? byte_count : space;
+        memcpy(&tx_buffer[tx_byte_count], buffer, length);
+        tx_byte_count += length;
+        buffer += length;
+        byte_count -= length;
+
+        if (tx_byte_count == TX_BUFFER_LENGTH_B) tx_write_out();
     }
+}
+
+
+/**
+ * @brief Complete the outgoing response: write out any queued
+ *        data and have core 0 push it to the host. Core 1 only.
+ *        FROM 1.3.0
+ */
+void tx_flush(void) {
+
+    if (tx_byte_count > 0) tx_write_out();
+    engine_request_flush();
+}
+
+
+/**
+ * @brief Pass the queued data to core 0 in a single call.
+ *        FROM 1.3.0
+ */
+static void tx_write_out(void) {
+
+    // FROM 1.3.0 -- core 0 passes the data to the host
+    engine_put_reply(tx_buffer, tx_byte_count);
+    tx_byte_count = 0;
+}
+
+
+/**
+ * @brief Callback triggered by the transport when the host has sent data.
+ *        FROM 1.3.0
+ *
+ * @param param: Unused.
+ */
+static void rx_notify(void* param) {
 
-    // stdio_flush();
+    rx_pending = true;
+    __sev();
 }
 
 
@@ -651,13 +2285,18 @@ static void sig_handler(int signal) {
  * @returns A bitfield indicating usage:
  *          Bit 0 - GPIO
  *              1 - I2C
+ *              2 - SPI
+ *              3 - UART
  *              5 - 1-Wire
  *          All other bits reserved for future use.
  */
 uint8_t is_pin_taken(uint32_t pin) {
 
     uint8_t bitfield = is_pin_in_use_by_gpio(&gpio_state, pin) ? PIN_USAGE_FIELD_GPIO : 0;
-    bitfield |= is_pin_in_use_by_i2c(&i2c_state, pin) ? PIN_USAGE_FIELD_I2C : 0;
+    bitfield |= is_pin_in_use_by_i2c(&i2c_states[0], pin) ? PIN_USAGE_FIELD_I2C : 0;
+    bitfield |= is_pin_in_use_by_i2c(&i2c_states[1], pin) ? PIN_USAGE_FIELD_I2C : 0;
     bitfield |= is_pin_in_use_by_ow(&ow_state, pin) ? PIN_USAGE_FIELD_ONEWIRE : 0;
+    bitfield |= is_pin_in_use_by_spi(&spi_state, pin) ? PIN_USAGE_FIELD_SPI : 0;
+    bitfield |= is_pin_in_use_by_uart(&uart_state, pin) ? PIN_USAGE_FIELD_UART : 0;
     return bitfield;
 }
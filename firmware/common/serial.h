@@ -23,6 +23,7 @@
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
+#include "hardware/sync.h"
 #include "pico/unique_id.h"
 // App Includes
 #include "led.h"
@@ -30,6 +31,11 @@
 #include "i2c.h"
 #include "errors.h"
 #include "onewire.h"
+#include "spi.h"
+#include "uart.h"
+#include "transport.h"
+#include "engine.h"
+#include "trace.h"
 
 #ifdef DO_UART_DEBUG
 #include "debug.h"
@@ -40,9 +46,6 @@
  * CONSTANTS
  */
 #define SERIAL_READ_TIMEOUT_US                  10
-#define RX_LOOP_DELAY_MS                        5
-#define HEARTBEAT_PERIOD_US                     2000000
-#define HEARTBEAT_FLASH_US                      50000
 
 #define WRITE_LENGTH_BASE                       0xC0
 #define READ_LENGTH_BASE                        0x80
@@ -57,9 +60,11 @@
 #define ACK                                     0x0F
 #define ERR                                     0xF0
 
+// FROM 1.3.0
+#define GPIO_CLEAR_PIN_POSTFIX                  0xF0
+
 // FROM 1.1.2
 #define UART_LOOP_DELAY_MS                      1
-#define RX_BUFFER_LENGTH_B                      128
 
 // FROM 1.1.3
 #define MODE_CODE_NONE                          '0'
@@ -72,24 +77,164 @@
 #define MAX_NUMBER_OF_MODES                     4
 
 #define COLOUR_MODE_I2C                         0x002010 // Cyan
-#define COLOUR_MODE_SPI                         0x010000 //0x100010
-#define COLOUR_MODE_UART                        0x010000 //0x001000
+#define COLOUR_MODE_SPI                         0x100010 // Magenta
+#define COLOUR_MODE_UART                        0x001000 // Green
 #define COLOUR_MODE_ONE_WIRE                    0x101000 // Yellow
 #define COLOUR_MODE_ONE_NONE                    0x100000 // Red
 
 #define ERROR_BUFFER_LENGTH_B                   129
-#define BUS_RX_BUFFER_LENGTH_B                  65
 
 #define PIN_USAGE_FIELD_GPIO                    0x01
 #define PIN_USAGE_FIELD_I2C                     0x02
+#define PIN_USAGE_FIELD_SPI                     0x04
+#define PIN_USAGE_FIELD_UART                    0x08
 #define PIN_USAGE_FIELD_ONEWIRE                 0x10
 
+// FROM 1.3.0
+#define FRAME_BYTE_TIMEOUT_US                   5000
+#define TX_BUFFER_LENGTH_B                      64      // One USB full-speed packet
+#define EXTENDED_FRAME_MAX_B                    4096
+#define EXTENDED_HEADER_LENGTH_B                3       // 'W'/'R' then 16-bit LE length
+#define WINDOW_FRAME_CMD                        '>'
+#define WINDOW_HEADER_LENGTH_B                  4       // '>', sequence number, then 16-bit LE length
+#define WINDOW_FRAME_MAX_B                      (EXTENDED_FRAME_MAX_B + EXTENDED_HEADER_LENGTH_B)
+#define NO_SEQUENCE                             -1
+#define PROGRAM_CMD                             'T'     // Then 16-bit LE length, then ops
+#define PROGRAM_OPS_MAX                         32
+#define PROGRAM_OP_SKIPPED                      0xFF    // Status of ops after a failure
+
+// Transaction program opcodes
+#define PROGRAM_OP_I2C_WRITE                    0x01    // Address, 16-bit LE length, data
+#define PROGRAM_OP_I2C_READ                     0x02    // Address, 16-bit LE length
+#define PROGRAM_OP_I2C_STOP                     0x03    // Issue STOP after the previous I2C op
+#define PROGRAM_OP_OW_RESET                     0x10
+#define PROGRAM_OP_OW_WRITE                     0x11    // 16-bit LE length, data
+#define PROGRAM_OP_OW_READ                      0x12    // 16-bit LE length
+#define PROGRAM_OP_OW_READ_CRC8                 0x13    // 16-bit LE length, including a trailing CRC8
+#define PROGRAM_OP_OW_READ_CRC16                0x14    // 16-bit LE length, including a trailing inverted CRC16
+#define PROGRAM_OP_DELAY                        0x20    // 16-bit LE delay in microseconds
+#define RX_BUFFER_LENGTH_B                      (WINDOW_HEADER_LENGTH_B + WINDOW_FRAME_MAX_B + 1)
+#define BUS_RX_BUFFER_LENGTH_B                  (EXTENDED_FRAME_MAX_B + 1)
+// I2C transfer timeouts scale with the number of bytes moved
+#define I2C_BASE_TIMEOUT_US                     1000
+#define I2C_BYTE_TIMEOUT_US                     100
+#define I2C_TRANSFER_TIMEOUT_US(n)              (I2C_BASE_TIMEOUT_US + (n) * I2C_BYTE_TIMEOUT_US)
+#define STATUS_CMD                              'q'
+#define STATUS_RECORD_VERSION                   1
+#define STATUS_FLAG_READY                       0x01
+#define STATUS_FLAG_STARTED                     0x02
+#define STATUS_FLAG_OVERDRIVE                   0x04    // 1-Wire slots run at overdrive speed
+#define PERF_CMD                                'm'     // Then flags
+#define PERF_RECORD_VERSION                     1
+#define PERF_FLAG_RESET                         0x01    // Clear the counters once sent
+#define PERF_COMMAND_SLOTS                      130     // ASCII commands, then reads, then writes
+#define PERF_SLOT_READ                          128
+#define PERF_SLOT_WRITE                         129
+#define PERF_HISTOGRAM_BUCKETS                  20      // Bucket n counts latencies of 2^(n-1) to 2^n - 1us
+#define TRACE_CMD                               'L'     // Then flags
+#define TRACE_FLAG_CLEAR                        0x01    // Clear the trace once sent
+#define SAMPLE_CMD                              'J'     // Then 16-bit LE length, 16-bit LE period (ms), program
+#define SAMPLE_PERIOD_LENGTH_B                  2
+#define SAMPLE_PROGRAM_MAX_B                    256
+#define SAMPLE_MARKER                           0xA5    // First byte of every streamed sample record
+#define SAMPLE_FLAG_ERROR                       0x01    // The program failed: `error` says why
+#define SAMPLE_FLAG_OVERRUN                     0x02    // Samples were missed since the last record
+#define SAMPLE_FLAG_STOPPED                     0x04    // The job has ended: no more records follow
+#define SAMPLE_FLAG_TRIGGER                     0x08    // The record is from a pin trigger, not the timer
+#define TRIGGER_CMD                             'G'     // Then 16-bit LE length, pin, edges, program
+#define TRIGGER_HEADER_LENGTH_B                 2       // Pin and edges
+#define SPI_TRANSFER_CMD                        'X'     // Then 16-bit LE length, data
+#define UART_READ_CMD                           'U'     // Then 16-bit LE maximum length
+#define I2C_BUS_CMD                             'b'     // Then the I2C controller, 0 or 1
+#define OW_SPEED_CMD                            'o'     // Then the speed, then an 8-byte ROM ID
+#define OW_SEARCH_CMD                           'S'     // Then flags, then a family code (0 = any)
+#define OW_TRIPLET_CMD                          'Y'     // Then the direction to take at a discrepancy
+#define OW_TEMPERATURES_CMD                     'C'     // Then flags
+
+
+/*
+ * STRUCTURES
+ */
+// FROM 1.3.0
+// Board identity, fixed at boot
+typedef struct {
+    uint8_t     fw_major;
+    uint8_t     fw_minor;
+    uint8_t     fw_patch;
+    uint16_t    build_number;
+    uint8_t     board_id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES];
+    char        board_id_string[2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1];
+    char        model[HW_MODEL_NAME_SIZE_MAX + 1];
+} BoardIdentity;
+
+// FROM 1.3.0
+// Binary status record returned by STATUS_CMD. Little-endian, packed:
+// the client decodes it by copying it into the same structure
+typedef struct __attribute__((packed)) {
+    uint8_t     record_version;
+    uint8_t     mode;
+    uint8_t     fw_major;
+    uint8_t     fw_minor;
+    uint8_t     fw_patch;
+    uint16_t    build_number;
+    uint8_t     board_id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES];
+    char        model[HW_MODEL_NAME_SIZE_MAX];
+    uint8_t     flags;
+    uint8_t     bus;                // I2C, SPI or UART bus ID
+    uint8_t     pins[2];            // I2C SDA and SCL, SPI SCK and TX, UART TX and RX, or 1-Wire data
+    uint8_t     address;            // Target I2C address, or SPI CS pin
+    uint16_t    frequency_khz;      // I2C or SPI bus frequency, or UART baud rate / 1000
+    uint8_t     device_count;       // 1-Wire devices found
+    uint8_t     last_error;
+} StatusRecord;
+
+// FROM 1.3.0
+// Performance record returned by PERF_CMD: this header, then a PerfSlot
+// for each command seen since the counters were cleared. Little-endian, packed
+typedef struct __attribute__((packed)) {
+    uint8_t     record_version;
+    uint8_t     slot_count;
+    uint8_t     bucket_count;
+    uint8_t     reserved;
+    uint32_t    elapsed_ms;         // Since the counters were cleared
+    uint32_t    rejected_frames;    // Incomplete or badly sized frames
+    uint32_t    i2c_bytes_written;
+    uint32_t    i2c_bytes_read;
+    uint32_t    i2c_nak_count;
+    uint32_t    i2c_timeout_count;
+    uint32_t    ow_bytes_written;
+    uint32_t    ow_bytes_read;
+} PerfHeader;
+
+typedef struct __attribute__((packed)) {
+    uint8_t     command;            // ASCII command, READ_LENGTH_BASE or WRITE_LENGTH_BASE
+    uint32_t    count;
+    uint32_t    latency[PERF_HISTOGRAM_BUCKETS];    // Frame receipt to reply, log2 microseconds
+} PerfSlot;
+
+// FROM 1.3.0
+// Header of each record streamed by a sampling job or pin trigger,
+// followed by `length` bytes read by the program. Little-endian, packed
+typedef struct __attribute__((packed)) {
+    uint8_t     marker;             // SAMPLE_MARKER
+    uint8_t     flags;              // SAMPLE_FLAG_* values
+    uint8_t     error;              // The failed op's error code, or 0
+    uint8_t     pin;                // The trigger's pin, if SAMPLE_FLAG_TRIGGER is set
+    uint32_t    timestamp_us;       // Low 32 bits of `time_us_64()` when the sample was due, or the edge came
+    uint16_t    sequence;           // Sample number, from 0 when the job starts
+    uint16_t    length;
+} SampleHeader;
+
+
 /*
  * PROTOTYPES
  */
 void        rx_loop(void);
 void        tx(uint8_t* buffer, uint32_t byte_count);
+void        tx_queue(uint8_t* buffer, uint32_t byte_count);
+void        tx_flush(void);
 uint8_t     is_pin_taken(uint32_t pin);
+BoardIdentity* get_board_identity(void);
 
 
 #endif  // _MONITOR_HEADER_
@@ -0,0 +1,311 @@
+/*
+ * Depot RP2040 Bus Host Firmware - SPI functions
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#include "spi.h"
+
+
+/*
+ * STATIC PROTOTYPES
+ */
+static bool check_spi_pins(uint8_t* data);
+
+
+/*
+ * GLOBALS
+ */
+// DMA sources and sinks for one-way transfers
+static const uint8_t spi_fill_byte = SPI_READ_FILL_BYTE;
+static uint8_t spi_sink_byte;
+
+
+/**
+ * @brief Initialise the host's SPI bus. Chip select is driven as
+ *        a GPIO so it can be held across several transfers.
+ *
+ * @param sps: The SPI state record.
+ */
+void init_spi(SPI_State* sps) {
+
+    // Initialise SPI via SDK
+    // NOTE The RP2040 only supports MSB-first transfers
+    sps->actual_baud_khz = spi_init(sps->bus, sps->baud_khz * 1000) / 1000;
+    spi_set_format(sps->bus, 8,
+                   (sps->mode & SPI_MODE_CPOL) ? SPI_CPOL_1 : SPI_CPOL_0,
+                   (sps->mode & SPI_MODE_CPHA) ? SPI_CPHA_1 : SPI_CPHA_0,
+                   SPI_MSB_FIRST);
+
+    // Initialise pins
+    gpio_set_function(sps->sck_pin, GPIO_FUNC_SPI);
+    gpio_set_function(sps->tx_pin, GPIO_FUNC_SPI);
+    gpio_set_function(sps->rx_pin, GPIO_FUNC_SPI);
+    gpio_init(sps->cs_pin);
+    gpio_set_dir(sps->cs_pin, GPIO_OUT);
+    gpio_put(sps->cs_pin, true);
+    sps->is_selected = false;
+
+    // Claim a DMA channel for each direction
+    if (sps->dma_tx_channel < 0) sps->dma_tx_channel = dma_claim_unused_channel(true);
+    if (sps->dma_rx_channel < 0) sps->dma_rx_channel = dma_claim_unused_channel(true);
+
+    // Mark bus as ready for use
+    sps->is_ready = true;
+
+#ifdef DO_UART_DEBUG
+    debug_log("SPI activated at %ikHz", sps->actual_baud_khz);
+#endif
+}
+
+
+/**
+ * @brief De-initialise the host's SPI bus and release its pins.
+ *
+ * @param sps: The SPI state record.
+ */
+void deinit_spi(SPI_State* sps) {
+
+    if (!sps->is_ready) return;
+
+    // De-initialise SPI via SDK
+    spi_deinit(sps->bus);
+    gpio_deinit(sps->sck_pin);
+    gpio_deinit(sps->tx_pin);
+    gpio_deinit(sps->rx_pin);
+    gpio_deinit(sps->cs_pin);
+
+    dma_channel_unclaim(sps->dma_tx_channel);
+    dma_channel_unclaim(sps->dma_rx_channel);
+    sps->dma_tx_channel = -1;
+    sps->dma_rx_channel = -1;
+
+    sps->is_ready = false;
+    sps->is_selected = false;
+
+#ifdef DO_UART_DEBUG
+    debug_log("SPI deactivated");
+#endif
+}
+
+
+/**
+ * @brief Reset the host's SPI bus.
+ *
+ * @param sps: The SPI state record.
+ */
+void reset_spi(SPI_State* sps) {
+
+    deinit_spi(sps);
+    sleep_ms(10);
+    init_spi(sps);
+
+#ifdef DO_UART_DEBUG
+    debug_log("SPI reset");
+#endif
+}
+
+
+/**
+ * @brief Configure the SPI bus: its ID, pins, clock and mode.
+ *
+ * @param sps:  The SPI state record.
+ * @param data: The received data. Byte 0 is the bus ID, bytes 1-4 the
+ *              SCK, TX, RX and CS pins, byte 5 the mode, and bytes 6
+ *              and 7 the clock in kHz, little-endian.
+ *
+ * @returns Whether the config was set successfully (`true`) or not (`false`).
+ */
+bool configure_spi(SPI_State* sps, uint8_t* data) {
+
+#ifdef DO_UART_DEBUG
+    debug_log("Switching SPI to bus %i, pins %i, %i, %i, %i", data[0], data[1], data[2], data[3], data[4]);
+#endif
+
+    // Make sure we have valid data
+    if (sps->is_ready || !check_spi_pins(data)) {
+        return false;
+    }
+
+    uint32_t baud_khz = data[6] | (data[7] << 8);
+    if (baud_khz == 0) baud_khz = SPI_DEFAULT_BAUD_KHZ;
+    if (baud_khz > SPI_MAX_BAUD_KHZ) baud_khz = SPI_MAX_BAUD_KHZ;
+
+    // Store the values
+    sps->bus = (data[0] & 0x01) == 0 ? spi0 : spi1;
+    sps->sck_pin = data[1];
+    sps->tx_pin = data[2];
+    sps->rx_pin = data[3];
+    sps->cs_pin = data[4];
+    sps->mode = data[5] & (SPI_MODE_CPHA | SPI_MODE_CPOL);
+    sps->baud_khz = baud_khz;
+    return true;
+}
+
+
+/**
+ * @brief Assert or release the chip-select line.
+ *
+ * @param sps:         The SPI state record.
+ * @param is_selected: Assert CS (`true`) or release it (`false`).
+ */
+void select_spi(SPI_State* sps, bool is_selected) {
+
+    // CS is active low
+    gpio_put(sps->cs_pin, !is_selected);
+    sps->is_selected = is_selected;
+}
+
+
+/**
+ * @brief Clock bytes out and in at the same time. Longer transfers are
+ *        run by a pair of DMA channels paced by the SPI peripheral, so
+ *        the bus runs at full speed without the CPU moving each byte.
+ *
+ * @param sps:        The SPI state record.
+ * @param tx_data:    The bytes to send, or `NULL` to send SPI_READ_FILL_BYTE.
+ * @param rx_data:    A buffer for the bytes received, or `NULL` to discard them.
+ * @param byte_count: The number of bytes to transfer.
+ *
+ * @returns The number of bytes transferred.
+ */
+uint32_t transfer_spi(SPI_State* sps, const uint8_t* tx_data, uint8_t* rx_data, uint32_t byte_count) {
+
+    if (byte_count < SPI_DMA_MIN_B) {
+        if (tx_data == NULL) {
+            spi_read_blocking(sps->bus, SPI_READ_FILL_BYTE, rx_data, byte_count);
+        } else if (rx_data == NULL) {
+            spi_write_blocking(sps->bus, tx_data, byte_count);
+        } else {
+            spi_write_read_blocking(sps->bus, tx_data, rx_data, byte_count);
+        }
+    } else {
+        // NOTE The RX channel always runs, even when the received bytes
+        //      are discarded, to keep the RX FIFO from overflowing
+        dma_channel_config tx_config = dma_channel_get_default_config(sps->dma_tx_channel);
+        channel_config_set_transfer_data_size(&tx_config, DMA_SIZE_8);
+        channel_config_set_dreq(&tx_config, spi_get_dreq(sps->bus, true));
+        channel_config_set_read_increment(&tx_config, tx_data != NULL);
+        channel_config_set_write_increment(&tx_config, false);
+        dma_channel_configure(sps->dma_tx_channel, &tx_config,
+                              &spi_get_hw(sps->bus)->dr,
+                              tx_data != NULL ? tx_data : &spi_fill_byte,
+                              byte_count, false);
+
+        dma_channel_config rx_config = dma_channel_get_default_config(sps->dma_rx_channel);
+        channel_config_set_transfer_data_size(&rx_config, DMA_SIZE_8);
+        channel_config_set_dreq(&rx_config, spi_get_dreq(sps->bus, false));
+        channel_config_set_read_increment(&rx_config, false);
+        channel_config_set_write_increment(&rx_config, rx_data != NULL);
+        dma_channel_configure(sps->dma_rx_channel, &rx_config,
+                              rx_data != NULL ? rx_data : &spi_sink_byte,
+                              &spi_get_hw(sps->bus)->dr,
+                              byte_count, false);
+
+        // Start both together, then wait for the last byte in
+        dma_start_channel_mask((1u << sps->dma_tx_channel) | (1u << sps->dma_rx_channel));
+        dma_channel_wait_for_finish_blocking(sps->dma_rx_channel);
+    }
+
+    if (tx_data != NULL) sps->bytes_written_total += byte_count;
+    if (rx_data != NULL) sps->bytes_read_total += byte_count;
+    return byte_count;
+}
+
+
+/**
+ * @brief Send the host's SPI bus status.
+ *
+ * @param sps: The SPI state record.
+ */
+void send_spi_status(SPI_State* sps) {
+
+    BoardIdentity* identity = get_board_identity();
+
+    // Generate and return the status data string.
+    // Data in the form: "1.0.0.18.19.16.17.1000.0.1.3.0.44.A1B23C4D5E6F0A1B.PI-PICO"
+    char status_buffer[129] = {0};
+
+    sprintf(status_buffer, "%s.%s.%s.%i.%i.%i.%i.%i.%i.%i.%i.%i.%i.%s.%s\r\n",
+            (sps->is_ready    ? "1" : "0"),         // 2 chars
+            (sps->is_selected ? "1" : "0"),         // 2 chars
+            (sps->bus == spi0 ? "0" : "1"),         // 2 chars
+            sps->sck_pin,                           // 2-3 chars
+            sps->tx_pin,                            // 2-3 chars
+            sps->rx_pin,                            // 2-3 chars
+            sps->cs_pin,                            // 2-3 chars
+            sps->is_ready ? sps->actual_baud_khz : sps->baud_khz,  // 2-6 chars
+            sps->mode,                              // 2 chars
+            identity->fw_major,                     // 2-4 chars
+            identity->fw_minor,                     // 2-4 chars
+            identity->fw_patch,                     // 2-4 chars
+            identity->build_number,                 // 2-4 chars
+            identity->board_id_string,              // 17 chars
+            identity->model);                       // 2-17 chars
+                                                    // == 47-85 chars
+
+    // Send the data
+    tx(status_buffer, strlen(status_buffer));
+}
+
+
+/**
+ * @brief Check pin usage.
+ *
+ * @param sps: The SPI state record.
+ * @param pin: An arbitrary GPIO pin that we're checking.
+ *
+ * @returns `true` if the pin is in use by the bus, or `false`.
+ */
+bool is_pin_in_use_by_spi(SPI_State* sps, uint8_t pin) {
+
+    return ((pin == sps->sck_pin || pin == sps->tx_pin || pin == sps->rx_pin || pin == sps->cs_pin) && sps->is_ready);
+}
+
+
+/**
+ * @brief Zero the bus' performance counters.
+ *
+ * @param sps: The SPI state record.
+ */
+void clear_spi_counters(SPI_State* sps) {
+
+    sps->bytes_written_total = 0;
+    sps->bytes_read_total = 0;
+}
+
+
+/**
+ * @brief Check that supplied pins are valid SPI pins for the chosen bus.
+ *        On the RP2040, GPIO n belongs to SPI bus (n / 8) % 2, and
+ *        n % 4 gives its function: RX, CSn, SCK then TX.
+ *
+ * @param data: The transmitted config data.
+ *
+ * @returns Whether the pins are good (`true`) or not (`false`).
+ */
+static bool check_spi_pins(uint8_t* data) {
+
+    uint8_t bus_index = data[0] & 0x01;
+    uint8_t sck_pin = data[1];
+    uint8_t tx_pin = data[2];
+    uint8_t rx_pin = data[3];
+    uint8_t cs_pin = data[4];
+
+    if (sck_pin > SPI_PIN_MAX || tx_pin > SPI_PIN_MAX || rx_pin > SPI_PIN_MAX || cs_pin > SPI_PIN_MAX) return false;
+
+    // Each data pin must have the right function on the right bus
+    if (((sck_pin >> 3) & 0x01) != bus_index || (sck_pin & 0x03) != 2) return false;
+    if (((tx_pin >> 3) & 0x01) != bus_index || (tx_pin & 0x03) != 3) return false;
+    if (((rx_pin >> 3) & 0x01) != bus_index || (rx_pin & 0x03) != 0) return false;
+
+    // CS is a plain GPIO, so can be any other pin
+    if (cs_pin == sck_pin || cs_pin == tx_pin || cs_pin == rx_pin) return false;
+
+    if (is_pin_taken(sck_pin) > 0 || is_pin_taken(tx_pin) > 0 || is_pin_taken(rx_pin) > 0 || is_pin_taken(cs_pin) > 0) return false;
+    return true;
+}
+
@@ -0,0 +1,100 @@
+/*
+ * Depot RP2040 Bus Host Firmware - SPI functions
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#ifndef _HEADER_SPI_
+#define _HEADER_SPI_
+
+
+/*
+ * INCLUDES
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// Pico SDK Includes
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+#include "hardware/dma.h"
+// App Includes
+#include "serial.h"
+
+
+/*
+ * CONSTANTS
+ */
+// Board defaults, overridden in the board's CMakeLists.txt file.
+// These are the Pico's SPI0 pins 21, 22, 24 and 25
+#ifndef DEFAULT_SPI_BUS
+#define DEFAULT_SPI_BUS                         0
+#endif
+#ifndef DEFAULT_SPI_RX_PIN
+#define DEFAULT_SPI_RX_PIN                      16
+#endif
+#ifndef DEFAULT_SPI_CS_PIN
+#define DEFAULT_SPI_CS_PIN                      17
+#endif
+#ifndef DEFAULT_SPI_SCK_PIN
+#define DEFAULT_SPI_SCK_PIN                     18
+#endif
+#ifndef DEFAULT_SPI_TX_PIN
+#define DEFAULT_SPI_TX_PIN                      19
+#endif
+
+#define SPI_DEFAULT_BAUD_KHZ                    1000
+#define SPI_MAX_BAUD_KHZ                        62500   // clk_peri / 2 at the default 125MHz
+#define SPI_PIN_MAX                             29
+
+// Mode byte: the SPI mode (0-3)
+#define SPI_MODE_CPHA                           0x01
+#define SPI_MODE_CPOL                           0x02
+
+// Transfers shorter than this are quicker to run through the FIFOs
+// directly than to set up the DMA channels for
+#define SPI_DMA_MIN_B                           16
+#define SPI_READ_FILL_BYTE                      0x00    // Clocked out during reads
+
+
+/*
+ * STRUCTURES
+ */
+typedef struct {
+    bool        is_ready;
+    bool        is_selected;
+    uint8_t     sck_pin;
+    uint8_t     tx_pin;
+    uint8_t     rx_pin;
+    uint8_t     cs_pin;
+    uint8_t     mode;                       // SPI mode 0-3
+    uint32_t    baud_khz;                   // The requested clock
+    uint32_t    actual_baud_khz;            // The clock the SDK could provide
+    int         dma_tx_channel;
+    int         dma_rx_channel;
+    spi_inst_t* bus;
+    // Performance counters
+    uint32_t    bytes_written_total;
+    uint32_t    bytes_read_total;
+} SPI_State;
+
+
+/*
+ * PROTOTYPES
+ */
+void        init_spi(SPI_State* sps);
+void        deinit_spi(SPI_State* sps);
+void        reset_spi(SPI_State* sps);
+bool        configure_spi(SPI_State* sps, uint8_t* data);
+void        select_spi(SPI_State* sps, bool is_selected);
+uint32_t    transfer_spi(SPI_State* sps, const uint8_t* tx_data, uint8_t* rx_data, uint32_t byte_count);
+void        send_spi_status(SPI_State* sps);
+bool        is_pin_in_use_by_spi(SPI_State* sps, uint8_t pin);
+void        clear_spi_counters(SPI_State* sps);
+
+
+#endif  // _HEADER_SPI_
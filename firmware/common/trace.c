@@ -0,0 +1,89 @@
+/*
+ * Depot RP2040 Bus Host Firmware - Command trace
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#include "trace.h"
+
+
+/*
+ * A fixed ring of binary records, one per completed frame. Adding a record
+ * is a single struct copy, so the trace stays on in release builds, unlike
+ * UART logging, which changes the timing it's meant to observe. When the
+ * ring is full, the oldest record is overwritten.
+ *
+ * The trace is only accessed by the core running the bus engines, so it
+ * needs no locking.
+ */
+
+
+/*
+ * GLOBALS
+ */
+static TraceRecord  trace_records[TRACE_RECORD_COUNT];
+static uint32_t     trace_head = 0;         // Free-running count of records added
+static uint32_t     trace_tail = 0;         // Free-running index of the oldest record
+
+
+/**
+ * @brief Add a record, overwriting the oldest if the trace is full.
+ *
+ * @param record: The record to copy in.
+ */
+void trace_add(const TraceRecord* record) {
+
+    trace_records[trace_head & (TRACE_RECORD_COUNT - 1)] = *record;
+    trace_head++;
+    if (trace_head - trace_tail > TRACE_RECORD_COUNT) trace_tail = trace_head - TRACE_RECORD_COUNT;
+}
+
+
+/**
+ * @brief Get the number of records held.
+ *
+ * @returns The record count.
+ */
+uint32_t trace_count(void) {
+
+    return trace_head - trace_tail;
+}
+
+
+/**
+ * @brief Get the number of records lost to overwriting since the
+ *        trace was last cleared.
+ *
+ * @returns The lost record count.
+ */
+uint32_t trace_dropped(void) {
+
+    return trace_tail;
+}
+
+
+/**
+ * @brief Get a held record.
+ *
+ * @param index: The record's index, from 0 (the oldest) to `trace_count() - 1`.
+ *
+ * @returns A pointer to the record, or NULL if the index is out of range.
+ */
+TraceRecord* trace_get(uint32_t index) {
+
+    if (index >= trace_count()) return NULL;
+    return &trace_records[(trace_tail + index) & (TRACE_RECORD_COUNT - 1)];
+}
+
+
+/**
+ * @brief Remove all the records.
+ */
+void trace_clear(void) {
+
+    trace_head = 0;
+    trace_tail = 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Depot RP2040 Bus Host Firmware - Command trace
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#ifndef _TRACE_HEADER_
+#define _TRACE_HEADER_
+
+
+/*
+ * INCLUDES
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+
+/*
+ * CONSTANTS
+ */
+#define TRACE_RECORD_COUNT                      256     // Must be a power of two
+#define TRACE_RECORD_VERSION                    1
+#define TRACE_NO_SEQUENCE                       0xFF
+#define TRACE_BUS_FLAG_READY                    0x01
+#define TRACE_BUS_FLAG_STARTED                  0x02
+
+
+/*
+ * STRUCTURES
+ */
+// One completed frame. Little-endian, packed: sent to the host as is
+typedef struct __attribute__((packed)) {
+    uint32_t    received_us;        // Low 32 bits of `time_us_64()` at receipt
+    uint32_t    duration_us;        // Receipt to reply
+    uint16_t    length;             // Frame length in bytes
+    uint8_t     command;            // The frame's first byte
+    uint8_t     sequence;           // Window sequence number, or TRACE_NO_SEQUENCE
+    uint8_t     result;             // Error code, or 0 on success
+    uint8_t     mode;               // Bus mode when the frame completed
+    uint8_t     bus_flags;          // TRACE_BUS_FLAG_* values
+    uint8_t     reserved;
+} TraceRecord;
+
+// Sent ahead of the records by the trace dump command
+typedef struct __attribute__((packed)) {
+    uint8_t     record_version;
+    uint8_t     record_size;
+    uint16_t    record_count;
+    uint32_t    dropped_count;      // Records overwritten since the trace was cleared
+    uint32_t    now_us;             // Low 32 bits of `time_us_64()` at the dump
+} TraceHeader;
+
+
+/*
+ * PROTOTYPES
+ */
+void            trace_add(const TraceRecord* record);
+uint32_t        trace_count(void);
+uint32_t        trace_dropped(void);
+TraceRecord*    trace_get(uint32_t index);
+void            trace_clear(void);
+
+
+#endif  // _TRACE_HEADER_
@@ -0,0 +1,272 @@
+/*
+ * Depot RP2040 Bus Host Firmware - USB transport functions
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#include "transport.h"
+
+
+/*
+ * This file carries the Depot protocol between the host and `serial.c`.
+ *
+ * By default it does so via the Pico SDK's USB stdio. If the board's
+ * CMakeLists.txt sets `DEPOT_NATIVE_USB`, it instead talks directly to
+ * TinyUSB: the protocol gets its own CDC interface, read and written a
+ * packet at a time, and stdio moves to a second CDC interface for debug
+ * output only.
+ */
+
+
+#ifdef USE_NATIVE_USB
+
+/*
+ * STATIC PROTOTYPES
+ */
+static void debug_out_chars(const char* buffer, int length);
+static void debug_out_flush(void);
+static int  debug_in_chars(char* buffer, int length);
+
+
+/*
+ * GLOBALS
+ */
+static uint8_t  rx_packet[TRANSPORT_PACKET_LENGTH_B];
+static uint32_t rx_packet_length = 0;
+static uint32_t rx_packet_index = 0;
+static void     (*rx_callback)(void*) = NULL;
+
+static stdio_driver_t stdio_debug_cdc = {
+    .out_chars = debug_out_chars,
+    .out_flush = debug_out_flush,
+    .in_chars = debug_in_chars,
+#if PICO_STDIO_ENABLE_CRLF_SUPPORT
+    .crlf_enabled = PICO_STDIO_DEFAULT_CRLF
+#endif
+};
+
+
+/**
+ * @brief Bring up TinyUSB and route stdio to the debug interface.
+ *
+ * @returns `true` if the transport is ready, otherwise `false`.
+ */
+bool transport_init(void) {
+
+    if (!tusb_init()) return false;
+    stdio_set_driver_enabled(&stdio_debug_cdc, true);
+    return true;
+}
+
+
+/**
+ * @brief Read a single byte from the command interface. Bytes are
+ *        taken from the host a whole packet at a time.
+ *
+ * @param timeout_us: How long to wait for a byte.
+ *
+ * @returns The byte value, or `PICO_ERROR_TIMEOUT`.
+ */
+int transport_get_byte(uint32_t timeout_us) {
+
+    if (rx_packet_index == rx_packet_length) {
+        // Packet used up, so get the next one
+        absolute_time_t until = make_timeout_time_us(timeout_us);
+        rx_packet_index = 0;
+        rx_packet_length = 0;
+
+        while (rx_packet_length == 0) {
+            tud_task();
+            if (tud_cdc_n_available(TRANSPORT_CDC_COMMAND) > 0) {
+                rx_packet_length = tud_cdc_n_read(TRANSPORT_CDC_COMMAND, rx_packet, TRANSPORT_PACKET_LENGTH_B);
+            } else if (time_reached(until)) {
+                return PICO_ERROR_TIMEOUT;
+            }
+        }
+    }
+
+    return rx_packet[rx_packet_index++];
+}
+
+
+/**
+ * @brief Write bytes to the command interface.
+ *
+ * @param buffer:     A pointer to the bytes.
+ * @param byte_count: The number of bytes to write.
+ */
+void transport_put_bytes(const uint8_t* buffer, uint32_t byte_count) {
+
+    while (byte_count > 0) {
+        // Don't wait on a host that isn't there
+        if (!tud_cdc_n_connected(TRANSPORT_CDC_COMMAND)) return;
+
+        uint32_t written = tud_cdc_n_write(TRANSPORT_CDC_COMMAND, buffer, byte_count);
+        buffer += written;
+        byte_count -= written;
+
+        // FIFO full? Push it out and let TinyUSB drain it
+        if (byte_count > 0) {
+            tud_cdc_n_write_flush(TRANSPORT_CDC_COMMAND);
+            tud_task();
+        }
+    }
+}
+
+
+/**
+ * @brief Push any written bytes to the host.
+ */
+void transport_flush(void) {
+
+    tud_cdc_n_write_flush(TRANSPORT_CDC_COMMAND);
+    tud_task();
+}
+
+
+/**
+ * @brief Register a function to be called when the host sends data.
+ *
+ * @param callback: The function to call.
+ */
+void transport_set_rx_callback(void (*callback)(void*)) {
+
+    rx_callback = callback;
+}
+
+
+/**
+ * @brief Service TinyUSB. Must be called when the command loop is idle.
+ */
+void transport_task(void) {
+
+    tud_task();
+}
+
+
+/**
+ * @brief TinyUSB callback: data has arrived on a CDC interface.
+ *
+ * @param itf: The interface index.
+ */
+void tud_cdc_rx_cb(uint8_t itf) {
+
+    if (itf == TRANSPORT_CDC_COMMAND && rx_callback != NULL) rx_callback(NULL);
+}
+
+
+/**
+ * @brief stdio driver: write characters to the debug interface.
+ */
+static void debug_out_chars(const char* buffer, int length) {
+
+    if (!tud_cdc_n_connected(TRANSPORT_CDC_DEBUG)) return;
+
+    while (length > 0) {
+        uint32_t written = tud_cdc_n_write(TRANSPORT_CDC_DEBUG, buffer, length);
+        buffer += written;
+        length -= written;
+        if (length > 0) {
+            tud_cdc_n_write_flush(TRANSPORT_CDC_DEBUG);
+            tud_task();
+        }
+    }
+
+    tud_cdc_n_write_flush(TRANSPORT_CDC_DEBUG);
+}
+
+
+/**
+ * @brief stdio driver: flush the debug interface.
+ */
+static void debug_out_flush(void) {
+
+    tud_cdc_n_write_flush(TRANSPORT_CDC_DEBUG);
+}
+
+
+/**
+ * @brief stdio driver: read characters from the debug interface.
+ */
+static int debug_in_chars(char* buffer, int length) {
+
+    uint32_t count = tud_cdc_n_read(TRANSPORT_CDC_DEBUG, buffer, length);
+    return count > 0 ? (int)count : PICO_ERROR_NO_DATA;
+}
+
+#else
+
+/**
+ * @brief Bring up stdio over USB and allow 2s for the board to come up.
+ *
+ * @returns `true` if the transport is ready, otherwise `false`.
+ */
+bool transport_init(void) {
+
+    if (!stdio_usb_init()) return false;
+    stdio_set_translate_crlf(&stdio_usb, false);
+    stdio_flush();
+
+    // Don't let stdout buffer our output: `transport_flush()`
+    // controls when it's sent
+    setvbuf(stdout, NULL, _IONBF, 0);
+    return true;
+}
+
+
+/**
+ * @brief Read a single byte from the USB-fed stdin.
+ *
+ * @param timeout_us: How long to wait for a byte.
+ *
+ * @returns The byte value, or `PICO_ERROR_TIMEOUT`.
+ */
+int transport_get_byte(uint32_t timeout_us) {
+
+    return getchar_timeout_us(timeout_us);
+}
+
+
+/**
+ * @brief Write bytes to stdout in a single call.
+ *
+ * @param buffer:     A pointer to the bytes.
+ * @param byte_count: The number of bytes to write.
+ */
+void transport_put_bytes(const uint8_t* buffer, uint32_t byte_count) {
+
+    fwrite(buffer, 1, byte_count, stdout);
+}
+
+
+/**
+ * @brief Push any written bytes to the host.
+ */
+void transport_flush(void) {
+
+    stdio_flush();
+}
+
+
+/**
+ * @brief Register a function to be called when the host sends data.
+ *
+ * @param callback: The function to call.
+ */
+void transport_set_rx_callback(void (*callback)(void*)) {
+
+    stdio_set_chars_available_callback(callback, NULL);
+}
+
+
+/**
+ * @brief Nothing to do: stdio services USB in the background.
+ */
+void transport_task(void) {
+
+}
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ * Depot RP2040 Bus Host Firmware - USB transport functions
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#ifndef _TRANSPORT_HEADER_
+#define _TRANSPORT_HEADER_
+
+
+/*
+ * INCLUDES
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+// Pico SDK Includes
+#include "pico/stdlib.h"
+#ifdef USE_NATIVE_USB
+#include "tusb.h"
+#include "pico/stdio/driver.h"
+#endif
+
+
+/*
+ * CONSTANTS
+ */
+#define TRANSPORT_CDC_COMMAND                   0       // Depot protocol interface
+#define TRANSPORT_CDC_DEBUG                     1       // Debug stdio interface
+#define TRANSPORT_PACKET_LENGTH_B               64
+
+
+/*
+ * PROTOTYPES
+ */
+bool    transport_init(void);
+int     transport_get_byte(uint32_t timeout_us);
+void    transport_put_bytes(const uint8_t* buffer, uint32_t byte_count);
+void    transport_flush(void);
+void    transport_set_rx_callback(void (*callback)(void*));
+void    transport_task(void);
+
+
+#endif  // _TRANSPORT_HEADER_
@@ -0,0 +1,42 @@
+/*
+ * Depot RP2040 Bus Host Firmware - TinyUSB configuration
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#ifndef _TUSB_CONFIG_H_
+#define _TUSB_CONFIG_H_
+
+
+/*
+ * NOTE Only used by native USB builds: see `transport.c`
+ */
+
+#ifndef CFG_TUSB_MCU
+#define CFG_TUSB_MCU                            OPT_MCU_RP2040
+#endif
+
+#ifndef CFG_TUSB_OS
+#define CFG_TUSB_OS                             OPT_OS_PICO
+#endif
+
+#define CFG_TUSB_RHPORT0_MODE                   OPT_MODE_DEVICE
+#define CFG_TUD_ENDPOINT0_SIZE                  64
+
+// Two CDC interfaces: 0 for the Depot protocol, 1 for debug stdio
+#define CFG_TUD_CDC                             2
+#define CFG_TUD_MSC                             0
+#define CFG_TUD_HID                             0
+#define CFG_TUD_MIDI                            0
+#define CFG_TUD_VENDOR                          0
+
+// Buffer several packets in each direction
+#define CFG_TUD_CDC_RX_BUFSIZE                  512
+#define CFG_TUD_CDC_TX_BUFSIZE                  512
+#define CFG_TUD_CDC_EP_BUFSIZE                  64
+
+
+#endif  // _TUSB_CONFIG_H_
@@ -0,0 +1,347 @@
+/*
+ * Depot RP2040 Bus Host Firmware - UART bridge functions
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#include "uart.h"
+
+
+/*
+ * STATIC PROTOTYPES
+ */
+static bool     check_uart_pins(uint8_t* data);
+static void     start_uart_rx(UART_State* uas);
+static uint32_t uart_rx_pending(UART_State* uas);
+
+
+/*
+ * GLOBALS
+ */
+static uint8_t uart_rx_ring[UART_RX_RING_B] __attribute__((aligned(UART_RX_RING_B)));
+static uint8_t uart_tx_buffers[UART_TX_BUFFER_COUNT][UART_TX_BUFFER_B];
+static uint8_t uart_rx_staging[UART_RX_RING_B];
+
+
+/**
+ * @brief Initialise the host's UART and start receiving into the RX ring.
+ *
+ * @param uas: The UART state record.
+ */
+void init_uart(UART_State* uas) {
+
+    // Initialise UART via SDK
+    uas->actual_baud = uart_init(uas->bus, uas->baud);
+    uart_set_format(uas->bus, uas->data_bits, uas->stop_bits, uas->parity);
+    uart_set_fifo_enabled(uas->bus, true);
+
+    // Initialise pins
+    gpio_set_function(uas->tx_pin, GPIO_FUNC_UART);
+    gpio_set_function(uas->rx_pin, GPIO_FUNC_UART);
+
+    // Claim a DMA channel for each direction
+    if (uas->dma_rx_channel < 0) uas->dma_rx_channel = dma_claim_unused_channel(true);
+    if (uas->dma_tx_channel < 0) uas->dma_tx_channel = dma_claim_unused_channel(true);
+    uas->tx_next_buffer = 0;
+    start_uart_rx(uas);
+
+    // Mark bus as ready for use
+    uas->is_ready = true;
+
+#ifdef DO_UART_DEBUG
+    debug_log("UART bridge activated at %i baud", uas->actual_baud);
+#endif
+}
+
+
+/**
+ * @brief De-initialise the host's UART and release its pins.
+ *        Unsent and unread data is discarded.
+ *
+ * @param uas: The UART state record.
+ */
+void deinit_uart(UART_State* uas) {
+
+    if (!uas->is_ready) return;
+
+    dma_channel_abort(uas->dma_rx_channel);
+    dma_channel_abort(uas->dma_tx_channel);
+    dma_channel_unclaim(uas->dma_rx_channel);
+    dma_channel_unclaim(uas->dma_tx_channel);
+    uas->dma_rx_channel = -1;
+    uas->dma_tx_channel = -1;
+
+    // De-initialise UART via SDK
+    uart_deinit(uas->bus);
+    gpio_deinit(uas->tx_pin);
+    gpio_deinit(uas->rx_pin);
+    uas->is_ready = false;
+
+#ifdef DO_UART_DEBUG
+    debug_log("UART bridge deactivated");
+#endif
+}
+
+
+/**
+ * @brief Reset the host's UART, discarding unsent and unread data.
+ *
+ * @param uas: The UART state record.
+ */
+void reset_uart(UART_State* uas) {
+
+    deinit_uart(uas);
+    init_uart(uas);
+}
+
+
+/**
+ * @brief Configure the UART: its ID, pins and format.
+ *
+ * @param uas:  The UART state record.
+ * @param data: The received data. Byte 0 is the bus ID, byte 1 the TX pin,
+ *              byte 2 the RX pin, bytes 3-6 the baud rate, little-endian,
+ *              then the data bits, stop bits and parity.
+ *
+ * @returns Whether the config was set successfully (`true`) or not (`false`).
+ */
+bool configure_uart(UART_State* uas, uint8_t* data) {
+
+    // Make sure we have valid data
+    if (uas->is_ready || !check_uart_pins(data)) {
+        return false;
+    }
+
+    uint32_t baud = data[3] | (data[4] << 8) | (data[5] << 16) | (data[6] << 24);
+    if (baud == 0) baud = UART_DEFAULT_BAUD;
+    if (baud > UART_MAX_BAUD) return false;
+    if (data[7] < 5 || data[7] > 8 || data[8] < 1 || data[8] > 2 || data[9] > UART_PARITY_ODD) return false;
+
+    // Store the values
+    uas->bus = (data[0] & 0x01) == 0 ? uart0 : uart1;
+    uas->tx_pin = data[1];
+    uas->rx_pin = data[2];
+    uas->baud = baud;
+    uas->data_bits = data[7];
+    uas->stop_bits = data[8];
+    uas->parity = data[9];
+    return true;
+}
+
+
+/**
+ * @brief Send data out of the UART. The data is copied into the idle TX
+ *        buffer, so the call only waits if the previous block is still
+ *        being sent.
+ *
+ * @param uas:        The UART state record.
+ * @param data:       A pointer to the bytes to write.
+ * @param byte_count: The number of bytes to write, up to UART_TX_BUFFER_B.
+ */
+void write_uart(UART_State* uas, uint8_t* data, uint32_t byte_count) {
+
+    uint8_t* buffer = uart_tx_buffers[uas->tx_next_buffer];
+    memcpy(buffer, data, byte_count);
+
+    // Only one block is sent at a time
+    dma_channel_wait_for_finish_blocking(uas->dma_tx_channel);
+
+    dma_channel_config tx_config = dma_channel_get_default_config(uas->dma_tx_channel);
+    channel_config_set_transfer_data_size(&tx_config, DMA_SIZE_8);
+    channel_config_set_dreq(&tx_config, uart_get_dreq(uas->bus, true));
+    channel_config_set_read_increment(&tx_config, true);
+    channel_config_set_write_increment(&tx_config, false);
+    dma_channel_configure(uas->dma_tx_channel, &tx_config,
+                          &uart_get_hw(uas->bus)->dr,
+                          buffer,
+                          byte_count, true);
+
+    uas->tx_next_buffer = (uas->tx_next_buffer + 1) % UART_TX_BUFFER_COUNT;
+    uas->bytes_written_total += byte_count;
+}
+
+
+/**
+ * @brief Send the host whatever the UART has received, up to a limit,
+ *        as a UART_Read_Header and then the data. This never waits for
+ *        data: the header's length may be zero.
+ *
+ * @param uas:            The UART state record.
+ * @param byte_count_max: The most bytes to send.
+ */
+void send_uart_data(UART_State* uas, uint32_t byte_count_max) {
+
+    uint32_t byte_count = uart_rx_pending(uas);
+    if (byte_count > byte_count_max) byte_count = byte_count_max;
+
+    // Copy out of the ring, which may wrap, before replying: DMA keeps
+    // writing while we copy, so it's only safe to send once we know the
+    // bytes weren't overwritten mid-copy
+    uint32_t start = uas->rx_consumed & (UART_RX_RING_B - 1);
+    uint32_t first = byte_count < UART_RX_RING_B - start ? byte_count : UART_RX_RING_B - start;
+    memcpy(uart_rx_staging, &uart_rx_ring[start], first);
+    if (byte_count > first) memcpy(&uart_rx_staging[first], uart_rx_ring, byte_count - first);
+
+    // Did DMA lap the ring during the copy? If so, the oldest bytes we
+    // copied may be newer data: drop them and flag the overflow
+    uint32_t received = UART_RX_DMA_COUNT - dma_channel_hw_addr(uas->dma_rx_channel)->transfer_count;
+    uint32_t skip = 0;
+    if (received - uas->rx_consumed > UART_RX_RING_B) {
+        skip = received - uas->rx_consumed - UART_RX_RING_B;
+        if (skip > byte_count) skip = byte_count;
+        uas->bytes_dropped_total += skip;
+        uas->rx_overflowed = true;
+    }
+
+    UART_Read_Header header;
+    header.flags = (uas->rx_overflowed ? UART_READ_FLAG_OVERFLOW : 0) | (dma_channel_is_busy(uas->dma_tx_channel) ? UART_READ_FLAG_TX_BUSY : 0);
+    header.reserved = 0;
+    header.length = (uint16_t)(byte_count - skip);
+    tx_queue((uint8_t*)&header, sizeof(header));
+    tx_queue(&uart_rx_staging[skip], byte_count - skip);
+    tx_flush();
+
+    uas->rx_consumed += byte_count;
+    uas->rx_overflowed = false;
+    uas->bytes_read_total += byte_count - skip;
+
+    // Restart the RX channel if it has ever run its course
+    if (!dma_channel_is_busy(uas->dma_rx_channel) && uart_rx_pending(uas) == 0) start_uart_rx(uas);
+}
+
+
+/**
+ * @brief Send the host's UART status.
+ *
+ * @param uas: The UART state record.
+ */
+void send_uart_status(UART_State* uas) {
+
+    BoardIdentity* identity = get_board_identity();
+
+    // Generate and return the status data string.
+    // Data in the form: "1.1.4.5.115200.8.1.0.1.3.0.44.A1B23C4D5E6F0A1B.PI-PICO"
+    char status_buffer[129] = {0};
+
+    sprintf(status_buffer, "%s.%s.%i.%i.%i.%i.%i.%i.%i.%i.%i.%i.%s.%s\r\n",
+            (uas->is_ready     ? "1" : "0"),        // 2 chars
+            (uas->bus == uart0 ? "0" : "1"),        // 2 chars
+            uas->tx_pin,                            // 2-3 chars
+            uas->rx_pin,                            // 2-3 chars
+            uas->is_ready ? uas->actual_baud : uas->baud,  // 2-8 chars
+            uas->data_bits,                         // 2 chars
+            uas->stop_bits,                         // 2 chars
+            uas->parity,                            // 2 chars
+            identity->fw_major,                     // 2-4 chars
+            identity->fw_minor,                     // 2-4 chars
+            identity->fw_patch,                     // 2-4 chars
+            identity->build_number,                 // 2-4 chars
+            identity->board_id_string,              // 17 chars
+            identity->model);                       // 2-17 chars
+                                                    // == 43-79 chars
+
+    // Send the data
+    tx(status_buffer, strlen(status_buffer));
+}
+
+
+/**
+ * @brief Check pin usage.
+ *
+ * @param uas: The UART state record.
+ * @param pin: An arbitrary GPIO pin that we're checking.
+ *
+ * @returns `true` if the pin is in use by the bus, or `false`.
+ */
+bool is_pin_in_use_by_uart(UART_State* uas, uint8_t pin) {
+
+    return ((pin == uas->tx_pin || pin == uas->rx_pin) && uas->is_ready);
+}
+
+
+/**
+ * @brief Zero the bus' performance counters.
+ *
+ * @param uas: The UART state record.
+ */
+void clear_uart_counters(UART_State* uas) {
+
+    uas->bytes_written_total = 0;
+    uas->bytes_read_total = 0;
+    uas->bytes_dropped_total = 0;
+}
+
+
+/**
+ * @brief Check that supplied pins are valid UART pins for the chosen bus.
+ *        On the RP2040, GPIO n belongs to UART ((n + 4) / 8) % 2, and
+ *        is TX if n % 4 is 0, or RX if it is 1.
+ *
+ * @param data: The transmitted config data.
+ *
+ * @returns Whether the pins are good (`true`) or not (`false`).
+ */
+static bool check_uart_pins(uint8_t* data) {
+
+    uint8_t bus_index = data[0] & 0x01;
+    uint8_t tx_pin = data[1];
+    uint8_t rx_pin = data[2];
+
+    if (tx_pin > UART_PIN_MAX || rx_pin > UART_PIN_MAX) return false;
+    if ((((tx_pin + 4) >> 3) & 0x01) != bus_index || (tx_pin & 0x03) != 0) return false;
+    if ((((rx_pin + 4) >> 3) & 0x01) != bus_index || (rx_pin & 0x03) != 1) return false;
+
+    if (is_pin_taken(tx_pin) > 0 || is_pin_taken(rx_pin) > 0) return false;
+    return true;
+}
+
+
+/**
+ * @brief Have DMA copy every received byte into the RX ring.
+ *
+ * @param uas: The UART state record.
+ */
+static void start_uart_rx(UART_State* uas) {
+
+    dma_channel_config rx_config = dma_channel_get_default_config(uas->dma_rx_channel);
+    channel_config_set_transfer_data_size(&rx_config, DMA_SIZE_8);
+    channel_config_set_dreq(&rx_config, uart_get_dreq(uas->bus, false));
+    channel_config_set_read_increment(&rx_config, false);
+    channel_config_set_write_increment(&rx_config, true);
+    channel_config_set_ring(&rx_config, true, UART_RX_RING_BITS);
+    dma_channel_configure(uas->dma_rx_channel, &rx_config,
+                          uart_rx_ring,
+                          &uart_get_hw(uas->bus)->dr,
+                          UART_RX_DMA_COUNT, true);
+
+    uas->rx_consumed = 0;
+    uas->rx_overflowed = false;
+}
+
+
+/**
+ * @brief Get the number of received bytes not yet sent to the host. If
+ *        DMA has lapped the ring, the oldest bytes are lost: skip them
+ *        and flag the overflow.
+ *
+ * @param uas: The UART state record.
+ *
+ * @returns The number of bytes waiting in the RX ring.
+ */
+static uint32_t uart_rx_pending(UART_State* uas) {
+
+    // The channel counts down from UART_RX_DMA_COUNT as bytes arrive
+    uint32_t received = UART_RX_DMA_COUNT - dma_channel_hw_addr(uas->dma_rx_channel)->transfer_count;
+    uint32_t pending = received - uas->rx_consumed;
+    if (pending > UART_RX_RING_B) {
+        uas->bytes_dropped_total += pending - UART_RX_RING_B;
+        uas->rx_consumed = received - UART_RX_RING_B;
+        uas->rx_overflowed = true;
+        pending = UART_RX_RING_B;
+    }
+
+    return pending;
+}
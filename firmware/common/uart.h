@@ -0,0 +1,112 @@
+/*
+ * Depot RP2040 Bus Host Firmware - UART bridge functions
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#ifndef _HEADER_UART_
+#define _HEADER_UART_
+
+
+/*
+ * INCLUDES
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// Pico SDK Includes
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+#include "hardware/dma.h"
+// App Includes
+#include "serial.h"
+
+
+/*
+ * CONSTANTS
+ */
+// Board defaults, overridden in the board's CMakeLists.txt file.
+// These are the Pico's UART1 pins 6 and 7. UART0 on GPIO 16 and
+// 17 is used for debug output
+#ifndef DEFAULT_UART_BUS
+#define DEFAULT_UART_BUS                        1
+#endif
+#ifndef DEFAULT_UART_TX_PIN
+#define DEFAULT_UART_TX_PIN                     4
+#endif
+#ifndef DEFAULT_UART_RX_PIN
+#define DEFAULT_UART_RX_PIN                     5
+#endif
+
+#define UART_DEFAULT_BAUD                       115200
+#define UART_MAX_BAUD                           7812500 // clk_peri / 16 at the default 125MHz
+#define UART_PIN_MAX                            29
+
+// The RX ring is filled by DMA, which wraps its write address
+// within a naturally aligned power-of-two block
+#define UART_RX_RING_BITS                       13
+#define UART_RX_RING_B                          (1 << UART_RX_RING_BITS)
+#define UART_RX_DMA_COUNT                       0xFFFFFFFF
+// TX data is copied into one buffer while DMA sends the other
+#define UART_TX_BUFFER_COUNT                    2
+#define UART_TX_BUFFER_B                        4096
+
+#define UART_READ_HEADER_LENGTH_B               4
+#define UART_READ_FLAG_OVERFLOW                 0x01    // RX bytes were dropped since the last read
+#define UART_READ_FLAG_TX_BUSY                  0x02    // TX data is still being sent
+
+
+/*
+ * STRUCTURES
+ */
+typedef struct {
+    bool            is_ready;
+    uint8_t         tx_pin;
+    uint8_t         rx_pin;
+    uint8_t         data_bits;
+    uint8_t         stop_bits;
+    uint8_t         parity;                 // UART_PARITY_* values
+    uint32_t        baud;                   // The requested baud rate
+    uint32_t        actual_baud;            // The baud rate the SDK could provide
+    int             dma_rx_channel;
+    int             dma_tx_channel;
+    uart_inst_t*    bus;
+    // RX ring progress, counted since the RX DMA channel was started
+    uint32_t        rx_consumed;
+    bool            rx_overflowed;
+    // TX double buffer
+    uint32_t        tx_next_buffer;
+    // Performance counters
+    uint32_t        bytes_written_total;
+    uint32_t        bytes_read_total;
+    uint32_t        bytes_dropped_total;
+} UART_State;
+
+// Header of the reply to UART_READ_CMD, followed by `length` bytes.
+// Little-endian, packed
+typedef struct __attribute__((packed)) {
+    uint8_t         flags;                  // UART_READ_FLAG_* values
+    uint8_t         reserved;
+    uint16_t        length;
+} UART_Read_Header;
+
+
+/*
+ * PROTOTYPES
+ */
+void        init_uart(UART_State* uas);
+void        deinit_uart(UART_State* uas);
+void        reset_uart(UART_State* uas);
+bool        configure_uart(UART_State* uas, uint8_t* data);
+void        write_uart(UART_State* uas, uint8_t* data, uint32_t byte_count);
+void        send_uart_data(UART_State* uas, uint32_t byte_count_max);
+void        send_uart_status(UART_State* uas);
+bool        is_pin_in_use_by_uart(UART_State* uas, uint8_t pin);
+void        clear_uart_counters(UART_State* uas);
+
+
+#endif  // _HEADER_UART_
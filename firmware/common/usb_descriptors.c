@@ -0,0 +1,137 @@
+/*
+ * Depot RP2040 Bus Host Firmware - TinyUSB descriptors
+ *
+ * @version     1.3.0
+ * @author      Tony Smith (@smittytone)
+ * @copyright   2023
+ * @licence     MIT
+ *
+ */
+#include "tusb.h"
+#include "pico/unique_id.h"
+
+
+/*
+ * NOTE Only used by native USB builds: see `transport.c`
+ */
+
+
+/*
+ * CONSTANTS
+ */
+#define USBD_VID                                0x2E8A  // Raspberry Pi
+#define USBD_PID                                0x000A  // Pico SDK CDC
+#define USBD_MAX_POWER_MA                       250
+
+#define USBD_ITF_CDC_0                          0
+#define USBD_ITF_CDC_1                          2
+#define USBD_ITF_MAX                            4
+
+#define USBD_CDC_0_EP_CMD                       0x81
+#define USBD_CDC_0_EP_OUT                       0x02
+#define USBD_CDC_0_EP_IN                        0x82
+#define USBD_CDC_1_EP_CMD                       0x83
+#define USBD_CDC_1_EP_OUT                       0x04
+#define USBD_CDC_1_EP_IN                        0x84
+#define USBD_CDC_CMD_MAX_SIZE                   8
+#define USBD_CDC_IN_OUT_MAX_SIZE                64
+
+#define USBD_STR_0                              0x00
+#define USBD_STR_MANUF                          0x01
+#define USBD_STR_PRODUCT                        0x02
+#define USBD_STR_SERIAL                         0x03
+#define USBD_STR_CDC_0                          0x04
+#define USBD_STR_CDC_1                          0x05
+
+#define USBD_DESC_LEN                           (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN * CFG_TUD_CDC)
+#define USBD_STR_MAX_CHARS                      32
+
+
+/*
+ * GLOBALS
+ */
+static const tusb_desc_device_t usbd_desc_device = {
+    .bLength = sizeof(tusb_desc_device_t),
+    .bDescriptorType = TUSB_DESC_DEVICE,
+    .bcdUSB = 0x0200,
+    .bDeviceClass = TUSB_CLASS_MISC,
+    .bDeviceSubClass = MISC_SUBCLASS_COMMON,
+    .bDeviceProtocol = MISC_PROTOCOL_IAD,
+    .bMaxPacketSize0 = CFG_TUD_ENDPOINT0_SIZE,
+    .idVendor = USBD_VID,
+    .idProduct = USBD_PID,
+    .bcdDevice = 0x0130,
+    .iManufacturer = USBD_STR_MANUF,
+    .iProduct = USBD_STR_PRODUCT,
+    .iSerialNumber = USBD_STR_SERIAL,
+    .bNumConfigurations = 1,
+};
+
+static const uint8_t usbd_desc_cfg[USBD_DESC_LEN] = {
+    TUD_CONFIG_DESCRIPTOR(1, USBD_ITF_MAX, USBD_STR_0, USBD_DESC_LEN, 0, USBD_MAX_POWER_MA),
+    TUD_CDC_DESCRIPTOR(USBD_ITF_CDC_0, USBD_STR_CDC_0, USBD_CDC_0_EP_CMD, USBD_CDC_CMD_MAX_SIZE,
+                       USBD_CDC_0_EP_OUT, USBD_CDC_0_EP_IN, USBD_CDC_IN_OUT_MAX_SIZE),
+    TUD_CDC_DESCRIPTOR(USBD_ITF_CDC_1, USBD_STR_CDC_1, USBD_CDC_1_EP_CMD, USBD_CDC_CMD_MAX_SIZE,
+                       USBD_CDC_1_EP_OUT, USBD_CDC_1_EP_IN, USBD_CDC_IN_OUT_MAX_SIZE),
+};
+
+static char usbd_serial_str[PICO_UNIQUE_BOARD_ID_SIZE_BYTES * 2 + 1];
+
+static const char* const usbd_desc_str[] = {
+    [USBD_STR_MANUF] = "Raspberry Pi",
+    [USBD_STR_PRODUCT] = "Depot Bus Host",
+    [USBD_STR_SERIAL] = usbd_serial_str,
+    [USBD_STR_CDC_0] = "Depot Bus Host Commands",
+    [USBD_STR_CDC_1] = "Depot Bus Host Debug",
+};
+
+
+/**
+ * @brief TinyUSB callback: return the device descriptor.
+ */
+const uint8_t* tud_descriptor_device_cb(void) {
+
+    return (const uint8_t*)&usbd_desc_device;
+}
+
+
+/**
+ * @brief TinyUSB callback: return the configuration descriptor.
+ */
+const uint8_t* tud_descriptor_configuration_cb(uint8_t index) {
+
+    (void)index;
+    return usbd_desc_cfg;
+}
+
+
+/**
+ * @brief TinyUSB callback: return a string descriptor as UTF-16.
+ */
+const uint16_t* tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
+
+    static uint16_t desc_str[USBD_STR_MAX_CHARS + 1];
+    uint8_t length = 0;
+    (void)langid;
+
+    if (!usbd_serial_str[0]) {
+        pico_get_unique_board_id_string(usbd_serial_str, sizeof(usbd_serial_str));
+    }
+
+    if (index == 0) {
+        // Supported language: English
+        desc_str[1] = 0x0409;
+        length = 1;
+    } else {
+        if (index >= sizeof(usbd_desc_str) / sizeof(usbd_desc_str[0])) return NULL;
+
+        const char* str = usbd_desc_str[index];
+        for (length = 0 ; length < USBD_STR_MAX_CHARS && str[length] ; ++length) {
+            desc_str[1 + length] = str[length];
+        }
+    }
+
+    // First entry holds the byte length and descriptor type
+    desc_str[0] = (uint16_t)((TUSB_DESC_STRING << 8) | (2 * length + 2));
+    return desc_str;
+}
@@ -17,11 +17,9 @@ int main(void) {
     // Initialise the LED
     ws2812_init();
 
-    // Enable STDIO and allow 2s for the board to come up
-    if (stdio_usb_init()) {
-        stdio_set_translate_crlf(&stdio_usb, false);;
-        stdio_flush();
-
+    // Enable the USB command channel and allow 2s for the board to come up
+    // FROM 1.3.0 -- via stdio or native TinyUSB: see `transport.c`
+    if (transport_init()) {
         // Start the loop
         // Function defined in `serial.c`
         rx_loop();
@@ -30,7 +28,7 @@ int main(void) {
         return 0;
     }
 
-    // Could not initialize stdio over USB,
+    // Could not initialize USB,
     // so signal error (red) and end
     ws2812_set_colour(0xFF0000);
     ws2812_flash(10);